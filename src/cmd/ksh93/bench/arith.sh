@@ -0,0 +1,44 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Arithmetic: integer and floating point loops, arithmetic expansion
+# and 'let'.
+# Usage: ksh arith.sh [iterations]
+
+typeset -i n=${1:-200000} i s=0 x
+typeset -F3 SECONDS
+float f=0
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	((s += i * i % 7))
+done
+print -r -- "arith_integer	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	((f += i / 3.0 + sqrt(i)))
+done
+print -r -- "arith_float	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=$(( (i << 2 | 1) ^ s ))
+done
+print -r -- "arith_expansion	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	let "x = i % 13 ? x + 1 : x - 1"
+done
+print -r -- "arith_let	$SECONDS"
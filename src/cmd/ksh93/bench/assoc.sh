@@ -0,0 +1,44 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Associative arrays: insert, look up, iterate and unset keys.
+# Usage: ksh assoc.sh [number of keys]
+
+typeset -i n=${1:-1000000} i
+typeset -A a
+typeset -F3 SECONDS
+typeset k
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	a[key$i]=$i
+done
+print -r -- "assoc_insert	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	: ${a[key$(( (i*7919) % n ))]}
+done
+print -r -- "assoc_lookup	$SECONDS"
+
+SECONDS=0
+for k in "${!a[@]}"
+do	: "${a[$k]}"
+done
+print -r -- "assoc_iterate	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	unset "a[key$i]"
+done
+print -r -- "assoc_unset	$SECONDS"
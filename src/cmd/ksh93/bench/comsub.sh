@@ -0,0 +1,47 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Command substitution: of built-ins, in the current environment, of a
+# file's contents and of an external command.
+# Usage: ksh comsub.sh [number of substitutions]
+
+typeset -i n=${1:-20000} i
+typeset -F3 SECONDS
+typeset x file=${TMPDIR:-/tmp}/comsub.$$ echo=$(whence -p echo)
+
+trap 'rm -f "$file"' EXIT
+print 'some file contents' >$file
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=$(print -r -- "$i")
+done
+print -r -- "comsub_builtin	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=${ print -r -- "$i"; }
+done
+print -r -- "comsub_shared	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=$(<$file)
+done
+print -r -- "comsub_file	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n/20; i++))
+do	x=$("$echo" "$i")
+done
+print -r -- "comsub_external	$SECONDS"
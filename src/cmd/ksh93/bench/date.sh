@@ -0,0 +1,62 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Date conversion with printf %T: ISO 8601 and RFC 3339 timestamps as
+# written in logs, with and without a UTC offset, other date formats,
+# and formatting seconds since the epoch.
+# Usage: ksh date.sh [number of timestamps]
+
+typeset -i n=${1:-20000} i t
+typeset -F3 SECONDS
+typeset v
+typeset -a utc offset local other epoch sign=(+ -)
+
+# a corpus of timestamps a few seconds apart, spanning several days
+for ((i=0, t=1709251200; i<n; i++, t+=37))
+do	printf -v v '%(%Y-%m-%dT%H:%M:%S)T' "#$t"
+	epoch[i]=$t
+	utc[i]=$v.$((i%1000))Z
+	offset[i]=$v${sign[i%2]}0$((i%10)):$((i%2*3))0
+	local[i]=${v/T/ }
+	printf -v other[i] '%(%a %b %e %H:%M:%S %Y)T' "#$t"
+done
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	printf -v v '%(%s)T' "${utc[i]}"
+done
+print -r -- "date_iso_utc	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	printf -v v '%(%s)T' "${offset[i]}"
+done
+print -r -- "date_iso_offset	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	printf -v v '%(%s)T' "${local[i]}"
+done
+print -r -- "date_iso_local	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	printf -v v '%(%s)T' "${other[i]}"
+done
+print -r -- "date_other	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	printf -v v '%(%Y-%m-%dT%H:%M:%S)T' "#${epoch[i]}"
+done
+print -r -- "date_format	$SECONDS"
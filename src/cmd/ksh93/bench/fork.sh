@@ -0,0 +1,44 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Process creation: forked subshells, background jobs and external commands.
+# Usage: ksh fork.sh [number of processes]
+
+typeset -i n=${1:-2000} i
+typeset -F3 SECONDS
+typeset true=$(whence -p true)
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	(ulimit -t unlimited; :)	# 'ulimit' forces the subshell to fork
+done
+print -r -- "fork_subshell	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	: &
+	wait $!
+done
+print -r -- "fork_background	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	"$true"
+done
+print -r -- "fork_external	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	print | "$true"
+done
+print -r -- "fork_pipeline	$SECONDS"
@@ -0,0 +1,37 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Function call overhead: call trivial functions in a tight loop.
+# Usage: ksh funcall.sh [iterations]
+
+typeset -i n=${1:-1000000} i
+typeset -F3 SECONDS
+
+function noargs { :; }
+function withargs { :; }
+function withlocal { typeset x=$1; }
+posixfun() { :; }
+
+for f in noargs withargs withlocal posixfun
+do	SECONDS=0
+	case $f in
+	withargs | withlocal)
+		for ((i=0; i<n; i++))
+		do	$f one two three four
+		done ;;
+	*)	for ((i=0; i<n; i++))
+		do	$f
+		done ;;
+	esac
+	print -r -- "funcall_$f	$SECONDS"
+done
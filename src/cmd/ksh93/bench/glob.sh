@@ -0,0 +1,43 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Pathname expansion in a directory with many files.
+# Usage: ksh glob.sh [number of files]
+
+typeset -i n=${1:-2000} i
+typeset -F3 SECONDS
+typeset dir=${TMPDIR:-/tmp}/glob.$$
+
+trap 'cd / && rm -rf "$dir"' EXIT
+mkdir "$dir" && cd "$dir" || exit
+for ((i=0; i<n; i++))
+do	>f$i.txt >g$i.c
+done
+
+SECONDS=0
+for ((i=0; i<100; i++))
+do	set -- *
+done
+print -r -- "glob_all	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<100; i++))
+do	set -- f*[13579].txt
+done
+print -r -- "glob_pattern	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<100; i++))
+do	set -- @(f|g)+([0-9]).@(txt|c)
+done
+print -r -- "glob_extended	$SECONDS"
@@ -0,0 +1,43 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Here-documents and here-strings: many small ones and a few large ones.
+# Usage: ksh heredoc.sh [iterations]
+
+typeset -i n=${1:-20000} i
+typeset -F3 SECONDS
+typeset x data=$(for ((i=0; i<1000; i++)); do print "line $i of the document"; done)
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	read -r x <<-EOF
+	$i
+	EOF
+done
+print -r -- "heredoc_small	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	read -r x <<<"$i"
+done
+print -r -- "heredoc_string	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n/200; i++))
+do	while read -r x
+	do	:
+	done <<-EOF
+	$data
+	EOF
+done
+print -r -- "heredoc_large	$SECONDS"
@@ -0,0 +1,39 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Job-heavy script: a large number of background jobs that are started
+# first and then waited for one by one, which stresses the job table and
+# the list of saved exit statuses.
+# Usage: ksh jobs.sh [number of jobs]
+
+typeset -i n=${1:-20000} i s
+typeset -F3 SECONDS
+typeset -a pids
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	(exit $((i&127))) &
+	pids[i]=$!
+done
+print -r -- "jobs_start	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	wait ${pids[i]}
+	s=$?
+	if	((s != (i&127)))
+	then	print -u2 -r -- "jobs.sh: job $i: exit status $s"
+		exit 1
+	fi
+done
+print -r -- "jobs_wait	$SECONDS"
@@ -0,0 +1,66 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Load test for the mkservice and eloop built-ins, which are only available
+# if ksh was compiled with SHOPT_MKSERVICE. A background subshell runs a line
+# echo service on a loopback port; the client connects many times, keeping
+# all connections open, then sends a line on each and reads back the replies.
+# Usage: ksh mkservice.sh [connections [rounds [port]]]
+
+typeset -i nconn=${1:-1000} rounds=${2:-5} port=${3:-$((20000 + $$ % 20000))} i r fd
+typeset -F3 SECONDS
+typeset -a fds
+
+if	! whence -q mkservice eloop
+then	print -u2 "${0##*/}: this shell was compiled without SHOPT_MKSERVICE"
+	exit 1
+fi
+# each side needs a descriptor per connection
+ulimit -n $((nconn + 64)) 2>/dev/null || nconn=$(( $(ulimit -n) - 64 ))
+
+(
+	mkservice svc /dev/tcp/localhost/$port || exit
+	function svc.action
+	{
+		typeset line
+		read -r -u$1 line || return 1
+		print -r -u$1 -- "$line"
+	}
+	eloop -t 5000
+) &
+server=$!
+trap 'kill $server 2>/dev/null' EXIT
+
+# wait for the service to come up
+SECONDS=0
+until	(exec 3<>/dev/tcp/localhost/$port) 2>/dev/null
+do	((SECONDS < 5)) || exit
+	sleep .05
+done
+
+SECONDS=0
+for ((i=0; i<nconn; i++))
+do	exec {fd}<>/dev/tcp/localhost/$port
+	fds[i]=$fd
+done
+print -r -- "mkservice_connect	$SECONDS"
+for ((r=0; r<rounds; r++))
+do	SECONDS=0
+	for ((i=0; i<nconn; i++))
+	do	print -u${fds[i]} "$r $i"
+	done
+	for ((i=0; i<nconn; i++))
+	do	read -r -u${fds[i]} line && [[ $line == "$r $i" ]] || { print -u2 "bad reply on connection $i: $line"; exit 1; }
+	done
+	print -r -- "mkservice_round	$SECONDS"
+done
@@ -0,0 +1,42 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Read loops: reading lines and fields from a file and from a pipe.
+# Usage: ksh read.sh [number of lines]
+
+typeset -i n=${1:-50000} i
+typeset -F3 SECONDS
+typeset line a b c file=${TMPDIR:-/tmp}/read.$$
+
+trap 'rm -f "$file"' EXIT
+for ((i=0; i<n; i++))
+do	print -r -- "field$i second third and the rest"
+done >$file
+
+SECONDS=0
+while read -r line
+do	:
+done <$file
+print -r -- "read_lines	$SECONDS"
+
+SECONDS=0
+while IFS=' ' read -r a b c
+do	:
+done <$file
+print -r -- "read_fields	$SECONDS"
+
+SECONDS=0
+print -r -- "$(<$file)" | while read -r line
+do	:
+done
+print -r -- "read_pipe	$SECONDS"
@@ -0,0 +1,35 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Shell startup: start new shells that run a trivial command or script.
+# Usage: ksh startup.sh [number of shells]
+# $SHELL must be the path of the ksh to measure; the runner sets it.
+
+typeset -i n=${1:-500} i
+typeset -F3 SECONDS
+typeset ksh=${SHELL:-ksh} script=${TMPDIR:-/tmp}/startup.$$.sh
+
+trap 'rm -f "$script"' EXIT
+print : >$script
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	"$ksh" -c :
+done
+print -r -- "startup_command	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	"$ksh" "$script"
+done
+print -r -- "startup_script	$SECONDS"
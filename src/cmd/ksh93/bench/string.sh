@@ -0,0 +1,65 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# String operations: concatenation, pattern substitution, substrings,
+# pattern matching and prefix/suffix removal.
+# Usage: ksh string.sh [iterations]
+
+typeset -i n=${1:-100000} i
+typeset -F3 SECONDS
+typeset s x str='the quick brown fox jumps over the lazy dog; the dog sleeps'
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	((i % 1000)) || s=
+	s+=x$i
+done
+print -r -- "string_concat	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=${str//the/a}
+done
+print -r -- "string_substitute	$SECONDS"
+
+# a global substitution with many matches, each recorded in .sh.match
+x=
+for ((i=0; i<2000; i++))
+do	x+='the lazy dog '
+done
+SECONDS=0
+for ((i=0; i<n/1000; i++))
+do	s=${x//@(d)o@(g)/cat}
+done
+print -r -- "string_substitute_all	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=${str:i%50:10}
+done
+print -r -- "string_substring	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	[[ $str == *@(fox|cat)*dog* ]]
+	case $str in
+	*lazy*)	;;
+	esac
+done
+print -r -- "string_match	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	x=${str#* } x=${x%%;*} x=${x##*o}
+done
+print -r -- "string_trim	$SECONDS"
@@ -0,0 +1,51 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# The unordered tables: tracked aliases (Dtpset) and the ~user cache (Dtpbag).
+# Usage: ksh track.sh [number of commands]
+
+typeset -i n=${1:-2000} i r
+typeset -F3 SECONDS
+typeset dir=${TMPDIR:-/tmp}/track.$$ x
+typeset -a cmds
+
+trap 'cd / && rm -rf "$dir"' EXIT
+mkdir "$dir" && cd "$dir" || exit
+for ((i=0; i<n; i++))
+do	print '#!/bin/sh' >c$i
+	cmds[i]=c$i
+done
+chmod +x c*
+PATH=$dir:$PATH
+
+# each subshell gets a new table of tracked aliases that grows to n entries
+SECONDS=0
+for ((r=0; r<20; r++))
+do	(hash "${cmds[@]}")
+done
+print -r -- "track_add	$SECONDS"
+
+hash "${cmds[@]}"
+SECONDS=0
+for ((r=0; r<20; r++))
+do	for ((i=0; i<n; i++))
+	do	whence -q c$i
+	done
+done
+print -r -- "track_lookup	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<20*n; i++))
+do	x=~root
+done
+print -r -- "track_tilde_user	$SECONDS"
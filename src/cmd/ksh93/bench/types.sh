@@ -0,0 +1,44 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Type-heavy script: a large indexed array of 'typeset -T' type instances
+# with fixed-size members that is created, iterated over and destroyed.
+# Usage: ksh types.sh [number of instances]
+
+typeset -T Rec_t=(
+	integer id
+	float val
+	typeset -L8 tag
+)
+typeset -i n=${1:-50000} i
+typeset -F3 SECONDS
+Rec_t -a r
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	r[i].id=i
+	r[i].val=i/2.
+done
+print -r -- "types_create	$SECONDS"
+
+SECONDS=0
+float sum=0
+for ((i=0; i<n; i++))
+do	((sum += r[i].id + r[i].val))
+	r[i].tag=x$i
+done
+print -r -- "types_iterate	$SECONDS"
+
+SECONDS=0
+unset r
+print -r -- "types_unset	$SECONDS"
@@ -0,0 +1,49 @@
+########################################################################
+#                                                                      #
+#              This file is part of the ksh 93u+m package              #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+# Variable-heavy script: many distinct global and local variables that
+# are created, read, modified and unset by name.
+# Usage: ksh vars.sh [number of variables]
+
+typeset -i n=${1:-20000} i
+typeset -F3 SECONDS
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	eval "v_$i=$i"
+done
+for ((i=0; i<n; i++))
+do	nameref r=v_$i
+	((r += 1))
+	typeset +n r
+done
+print -r -- "vars_global	$SECONDS"
+
+function locals
+{
+	typeset -i j
+	for ((j=0; j<100; j++))
+	do	typeset l_$j=$j
+	done
+}
+SECONDS=0
+for ((i=0; i<n/100; i++))
+do	locals
+done
+print -r -- "vars_local	$SECONDS"
+
+SECONDS=0
+for ((i=0; i<n; i++))
+do	unset v_$i
+done
+print -r -- "vars_unset	$SECONDS"
@@ -16,6 +16,7 @@
 *                                                                      *
 ***********************************************************************/
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include	"defs.h"
 
 #define ENUM_ID "enum (ksh 93u+m) 2024-11-28"
@@ -428,6 +428,7 @@ int    b_wait(int n,char *argv[],Shbltin_t *context)
 		UNREACHABLE();
 	}
 	argv += opt_info.index;
+	sfsync(sfstdout);
 	job_bwait(argv);
 	return sh.exitval;
 }
@@ -591,6 +592,88 @@ int	b_times(int argc, char *argv[], Shbltin_t *context)
 	return 0;
 }
 
+#define TR_MAXCOUNT	(1<<20)	/* maximum number of events in the trace buffer */
+
+/*
+ * tracebuf [-c] [-n count] [-r file] [-w file]
+ */
+int	b_tracebuf(int argc, char *argv[], Shbltin_t *context)
+{
+	char		*rfile = 0, *wfile = 0;
+	Sflong_t	count = -1;
+	int		n, clear = 0;
+	Sfio_t		*iop;
+	NOT_USED(argc);
+	NOT_USED(context);
+	while((n = optget(argv,sh_opttracebuf))) switch(n)
+	{
+	    case 'c':
+		clear = 1;
+		break;
+	    case 'n':
+		count = opt_info.number;
+		if(count<0 || count>TR_MAXCOUNT)
+		{
+			errormsg(SH_DICT,ERROR_exit(1),"%s: invalid count (maximum %d)",opt_info.arg,TR_MAXCOUNT);
+			UNREACHABLE();
+		}
+		break;
+	    case 'r':
+		rfile = opt_info.arg;
+		break;
+	    case 'w':
+		wfile = opt_info.arg;
+		break;
+	    case ':':
+		errormsg(SH_DICT,2,"%s",opt_info.arg);
+		break;
+	    case '?':
+		errormsg(SH_DICT,ERROR_usage(2),"%s",opt_info.arg);
+		UNREACHABLE();
+	}
+	if(error_info.errors || argv[opt_info.index])
+	{
+		errormsg(SH_DICT,ERROR_usage(2),"%s",optusage(NULL));
+		UNREACHABLE();
+	}
+	if(wfile)
+	{
+		if(!(iop = sfopen(NULL,wfile,"w")))
+		{
+			errormsg(SH_DICT,ERROR_system(1),e_create,wfile);
+			UNREACHABLE();
+		}
+		n = sh_trwrite(iop);
+		if(sfclose(iop) || n)
+		{
+			errormsg(SH_DICT,ERROR_system(1),"%s: write error",wfile);
+			UNREACHABLE();
+		}
+	}
+	if(clear)
+		sh_trclear();
+	if(count>=0)
+		sh_trsize((size_t)count);
+	if(rfile)
+	{
+		if(!(iop = sfopen(NULL,rfile,"r")))
+		{
+			errormsg(SH_DICT,ERROR_system(1),e_open,rfile);
+			UNREACHABLE();
+		}
+		n = sh_trprint(iop,sfstdout);
+		sfclose(iop);
+		if(n)
+		{
+			errormsg(SH_DICT,ERROR_exit(1),"%s: %s",rfile,n==-3?"truncated tracebuf file":n==-2?"written on an incompatible system":"not a tracebuf file");
+			UNREACHABLE();
+		}
+	}
+	else if(!wfile && !clear && count<0)
+		sh_trprint(NULL,sfstdout);
+	return 0;
+}
+
 #if _cmd_universe
 /*
  * There are several universe styles that are masked by the getuniv(),
@@ -28,7 +28,7 @@
 #if SHOPT_MKSERVICE
 
 static const char mkservice_usage[] =
-"[-?\n@(#)$Id: mkservice (AT&T Research) 2001-06-13 $\n]"
+"[-?\n@(#)$Id: mkservice (ksh 93u+m) 2026-10-19 $\n]"
 "[--catalog?" SH_DICT "]"
 "[+NAME? mkservice - create a shell server ]"
 "[+DESCRIPTION?\bmkservice\b creates a tcp or udp server that is "
@@ -51,7 +51,10 @@ static const char mkservice_usage[] =
 		"to be read from one of the active connections.  It is "
 		"called with the file descriptor number that has data "
 		"to be read.  If the function returns a non-zero "
-		"value, this connection will be closed.]"
+		"value, this connection will be closed.  Connections do not "
+		"block: a \bread\b that finds no more input fails, and if the "
+		"client has not closed the connection, it is kept open and the "
+		"function is called again when more data arrives.]"
 	"[+close?This function is invoked when the connection is closed.]"
 	"}"
 "[+?If \avarname\a is unset, then all active connection, and the service "
@@ -69,11 +72,13 @@ static const char mkservice_usage[] =
 
 
 static const char eloop_usage[] =
-"[-?\n@(#)$Id: eloop (AT&T Research) 2001-06-13 $\n]"
+"[-?\n@(#)$Id: eloop (ksh 93u+m) 2026-10-19 $\n]"
 "[--catalog?" SH_DICT "]"
 "[+NAME? eloop - process event loop]"
 "[+DESCRIPTION?\beloop\b causes the shell to block waiting for events "
 	"to process.  By default, \beloop\b does not return.]"
+"[+?Traps and \balarm\b timers that fire while \beloop\b is waiting "
+	"are run without leaving the event loop.]"
 "[t]#[timeout?\atimeout\a is the number of milliseconds to wait "
 	"without receiving any events to process.]"
 "\n"
@@ -91,13 +96,21 @@ static const char eloop_usage[] =
 #include	<cmd.h>
 #include	<error.h>
 #include	<nval.h>
+#include	"io.h"
+#include	"FEATURE/poll"
 #include	<sys/socket.h>
 #include 	<netinet/in.h>
+#if _sys_epoll && _lib_epoll_create1
+#   include	<sys/epoll.h>
+#   define _use_epoll	1
+#endif
 
 #define ACCEPT	0
 #define ACTION	1
 #define CLOSE	2
 
+#define MAXEVENTS	64	/* events returned by one epoll_wait() */
+
 #ifndef O_SERVICE
 #   define O_SERVICE	O_NOCTTY
 #endif
@@ -117,6 +130,7 @@ struct Service_s
 	Namfun_t	fun;
 	int		fd;
 	int		refcount;
+	int		paused;		/* fd not watched: out of descriptors */
 	int		(*acceptf)(Service_t*,int);
 	int		(*actionf)(Service_t*,int,int);
 	int		(*errorf)(Service_t*,int,const char*, ...);
@@ -125,31 +139,162 @@ struct Service_s
 	Namval_t*	disc[elementsof(disctab)-1];
 };
 
-static int		*file_list;
+/*
+ * The file descriptors of all services and their connections are kept in
+ * file_list, and file_index gives the position of each descriptor in it, so
+ * adding or removing a connection takes constant time. With epoll, the kernel
+ * keeps the same set and a wait only returns the descriptors that are ready;
+ * otherwise, sfpoll() is used to scan all of them. Ready descriptors are
+ * queued in ready_list until their service functions have been called.
+ * When accept() runs out of descriptors, the connection socket is paused:
+ * it stays in service_list but is not waited on until a connection closes,
+ * as it would keep being reported ready.
+ */
+static Service_t	**service_list;	/* service of each file descriptor */
+static int		*file_list;	/* descriptors being waited on */
+static int		*file_index;	/* position of each descriptor in file_list */
+static int		*ready_list;	/* descriptors waiting to be processed */
+static char		*queued;	/* nonzero if descriptor is in ready_list */
 static Sfio_t		**poll_list;
-static Service_t	**service_list;
+static int		nfiles;		/* allocated size of the above */
 static int		npoll;
 static int		nready;
 static int		ready;
+static int		npaused;	/* number of paused services */
+#if _use_epoll
+static int		epfd = -1;
+#endif
+static Service_t	*active;	/* service whose action function is running */
 static int		(*covered_fdnotify)(int, int);
 
-static int fdclose(Service_t *sp, int fd)
+/*
+ * make room for file descriptor <fd>
+ */
+static void fdgrow(int fd)
 {
+	int n = nfiles;
+	if(fd < n)
+		return;
+	nfiles = fd < 2*n ? 2*n : fd+1;
+	if(nfiles < 64)
+		nfiles = 64;
+	service_list = sh_newof(service_list,Service_t*,nfiles,0);
+	file_list = sh_newof(file_list,int,nfiles,0);
+	file_index = sh_newof(file_index,int,nfiles,0);
+	ready_list = sh_newof(ready_list,int,nfiles,0);
+	queued = sh_newof(queued,char,nfiles,0);
+	poll_list = sh_newof(poll_list,Sfio_t*,nfiles+1,0);
+	memset(service_list+n,0,(nfiles-n)*sizeof(Service_t*));
+	memset(queued+n,0,nfiles-n);
+}
+
+/*
+ * start (<on> nonzero) or stop waiting on <fd>
+ */
+static void fdpoll(int fd, int on)
+{
+	int i = file_index[fd];
+#if _use_epoll
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if(epfd >= 0)
+		epoll_ctl(epfd,on?EPOLL_CTL_ADD:EPOLL_CTL_DEL,fd,&ev);
+#endif
+	if(on)
+	{
+		file_index[fd] = npoll;
+		file_list[npoll++] = fd;
+	}
+	else if(i < npoll && file_list[i]==fd)
+	{
+		file_list[i] = file_list[--npoll];
+		file_index[file_list[i]] = i;
+	}
+}
+
+static void fdwatch(Service_t *sp, int fd)
+{
+	fdgrow(fd);
+	service_list[fd] = sp;
+	fdpoll(fd,1);
+}
+
+static void fdunwatch(int fd)
+{
+	Service_t *sp = service_list[fd];
 	int i;
+	if(sp && sp->fd==fd && sp->paused)
+	{
+		sp->paused = 0;
+		npaused--;
+	}
+	else
+		fdpoll(fd,0);
 	service_list[fd] = 0;
-	if(sp->fd==fd)
-		sp->fd = -1;
-	for(i=0; i < npoll; i++)
+	if(queued[fd])
+	{
+		/* a new connection may reuse the descriptor before it is processed */
+		for(i=ready; i < nready; i++)
+			if(ready_list[i]==fd)
+				ready_list[i] = -1;
+		queued[fd] = 0;
+	}
+}
+
+/*
+ * wait on the connection sockets of paused services again
+ */
+static void fdresume(void)
+{
+	Service_t *sp;
+	int fd;
+	for(fd=0; npaused && fd < nfiles; fd++)
 	{
-		if(file_list[i]==fd)
+		if((sp = service_list[fd]) && sp->fd==fd && sp->paused)
 		{
-			file_list[i] = file_list[npoll--];
-			if(sp->actionf)
-				(*sp->actionf)(sp, fd, 1);
-			return 1;
+			sp->paused = 0;
+			npaused--;
+			fdpoll(fd,1);
 		}
 	}
-	return 0;
+}
+
+static void fdqueue(int fd)
+{
+	if(fd<0 || fd>=nfiles || queued[fd])
+		return;
+	if(nready==nfiles)
+	{
+		memmove(ready_list,ready_list+ready,(nready-ready)*sizeof(int));
+		nready -= ready;
+		ready = 0;
+	}
+	queued[fd] = 1;
+	ready_list[nready++] = fd;
+}
+
+static int fdclose(Service_t *sp, int fd)
+{
+	fdunwatch(fd);
+	if(sp->fd==fd)
+		sp->fd = -1;
+	else
+	{
+		/* a descriptor is free for a new connection */
+		if(npaused)
+			fdresume();
+		if(sp->actionf)
+			(*sp->actionf)(sp, fd, 1);
+	}
+	return 1;
+}
+
+static void fddrop(Service_t *sp, int fd)
+{
+	fdclose(sp,fd);
+	if(--sp->refcount==0)
+		nv_unset(sp->node);
 }
 
 static int fdnotify(int fd1, int fd2)
@@ -157,111 +302,180 @@ static int fdnotify(int fd1, int fd2)
 	Service_t *sp;
 	if (covered_fdnotify)
 		(*covered_fdnotify)(fd1, fd2);
+	if(fd1<0 || fd1>=nfiles || !(sp = service_list[fd1]))
+		return 0;
 	if(fd2!=SH_FDCLOSE)
 	{
-		int i;
-		service_list[fd2] = service_list[fd1];
-		service_list[fd1] = 0;
-		for(i=0; i < npoll; i++)
-		{
-			if(file_list[i]==fd1)
-			{
-				file_list[i] = fd2;
-				return 0;
-			}
-		}
-	}
-	else if(sp = service_list[fd1])
-	{
-		fdclose(sp,fd1);
-		if(--sp->refcount==0)
-			nv_unset(sp->node);
+		fdunwatch(fd1);
+		fdwatch(sp,fd2);
+		if(sp->fd==fd1)
+			sp->fd = fd2;
 	}
+	else
+		fddrop(sp,fd1);
 	return 0;
 }
 
-static void process_stream(Sfio_t* iop)
+/*
+ * check if input is left in the buffer of <iop>; this is the same test
+ * that sfgetc() uses, so no system call is needed
+ */
+static int buffered(Sfio_t *iop)
 {
-	int r=0, fd = sffileno(iop);
-	Service_t * sp = service_list[fd];
+	return iop->_next < iop->_endr;
+}
+
+/*
+ * check if the connection on <fd> is still open but has no input yet, so
+ * a read by the action function failed with EAGAIN rather than at end of file
+ */
+static int waiting(int fd)
+{
+	char	c;
+	return recv(fd, &c, 1, MSG_PEEK|MSG_DONTWAIT) < 0 && (errno==EAGAIN || errno==EWOULDBLOCK);
+}
+
+static void process_fd(int fd)
+{
+	Service_t	*sp;
+	Sfio_t		*iop;
+	int		r;
+	if(fd<0 || !(sp = service_list[fd]))
+		return;
 	if(fd==sp->fd)	/* connection socket */
 	{
-		struct sockaddr addr;
-		socklen_t addrlen = sizeof(addr);
-		fd = accept(fd, &addr, &addrlen);
-		service_list[fd] = sp;
-		sp->refcount++;
-		file_list[npoll++] = fd;
-		if(fd>=0)
+		/* the socket does not block, so accept all pending connections at once */
+		while((fd = accept(sp->fd, NULL, NULL)) >= 0)
 		{
-			if(sp->acceptf)
-				r = (*sp->acceptf)(sp,fd);
+			sp->refcount++;
+			if(sp->acceptf && (fd = (*sp->acceptf)(sp,fd)) < 0)
+			{
+				sp->refcount--;
+				continue;
+			}
+			/* the descriptor may have been used before; make the shell check it again */
+			sh_iovalidfd(fd);
+			sh.fdstatus[fd] = 0;
+			fdwatch(sp,fd);
+			/* give the connection its own buffered stream */
+			sh_fd2sfio(fd);
+			/* a client that stops sending must not block the other connections */
+			fcntl(fd, F_SETFL, fcntl(fd,F_GETFL,0)|O_NONBLOCK);
+			sh.fdstatus[fd] |= IONBLOCK;
+		}
+		if((errno==EMFILE || errno==ENFILE) && !sp->paused)
+		{
+			/* the pending connections are accepted when a descriptor is closed */
+			fdpoll(sp->fd,0);
+			sp->paused = 1;
+			npaused++;
 		}
 	}
 	else if(sp->actionf)
 	{
+		Service_t *saveactive = active;
 		service_list[fd] = 0;
+		active = sp;
 		r = (*sp->actionf)(sp, fd, 0);
+		if(!active)
+		{
+			/* the service was unset by the action function */
+			active = saveactive;
+			sh_close(fd);
+			return;
+		}
+		active = saveactive;
 		service_list[fd] = sp;
-		if(r<0)
-			close(fd);
+		if(fcntl(fd, F_GETFD, 0) < 0)
+			fddrop(sp,fd);		/* closed by the action function */
+		else if(r<0 && (iop = sh.sftable[fd]) && sferror(iop) && waiting(fd))
+			sfclrerr(iop);		/* call it again when the rest arrives */
+		else if(r<0)
+			sh_close(fd);
+		else if((iop = sh.sftable[fd]) && buffered(iop))
+			fdqueue(fd);		/* more input is buffered */
 	}
 }
 
 static int waitnotify(int fd, long timeout, int rw)
 {
 	Sfio_t	*special=0, **pstream;
-	int	i;
-
+	int	i, n, hit;
+	NOT_USED(rw);
 	if (fd >= 0)
 		special = sh_fd2sfio(fd);
 	while(1)
 	{
-		pstream = poll_list;
 		while(ready < nready)
-			process_stream(pstream[ready++]);
+		{
+			n = ready_list[ready++];
+			if(n >= 0)
+			{
+				queued[n] = 0;
+				process_fd(n);
+			}
+		}
+		ready = nready = 0;
+		errno = 0;
+#if _use_epoll
+		if(epfd >= 0)
+		{
+			struct epoll_event events[MAXEVENTS];
+			if(special)
+			{
+				if(buffered(special))
+					return fd;
+				events[0].events = EPOLLIN;
+				events[0].data.fd = fd;
+				epoll_ctl(epfd,EPOLL_CTL_ADD,fd,&events[0]);
+			}
+			n = epoll_wait(epfd,events,MAXEVENTS,timeout);
+			if(special)
+				epoll_ctl(epfd,EPOLL_CTL_DEL,fd,&events[MAXEVENTS-1]);
+			if(n<=0)
+				return errno? -1: 0;
+			for(hit=i=0; i < n; i++)
+			{
+				if(special && events[i].data.fd==fd)
+					hit = 1;
+				else
+					fdqueue(events[i].data.fd);
+			}
+			if(hit)
+				return fd;
+			continue;
+		}
+#endif /* _use_epoll */
+		pstream = poll_list;
 		if(special)
 			*pstream++ = special;
 		for(i=0; i < npoll; i++)
-		{
-			if(service_list[file_list[i]])
-				*pstream++ = sh_fd2sfio(file_list[i]);
-		}
+			*pstream++ = sh_fd2sfio(file_list[i]);
 		for(i=0; i < pstream-poll_list; i++)
 			sfset(poll_list[i],SFIO_WRITE,0);
-		nready = ready = 0;
-		errno = 0;
-#ifdef DEBUG
-		sfprintf(sfstderr,"before poll npoll=%d",pstream-poll_list);
-		for(i=0; i < pstream-poll_list; i++)
-			sfprintf(sfstderr," %d",sffileno(poll_list[i]));
-		sfputc(sfstderr,'\n');
-#endif
-		nready  = sfpoll(poll_list,pstream-poll_list,timeout);
-#ifdef DEBUG
-		sfprintf(sfstderr,"after poll nready=%d",nready);
-		for(i=0; i < nready; i++)
-			sfprintf(sfstderr," %d",sffileno(poll_list[i]));
-		sfputc(sfstderr,'\n');
-#endif
+		n = sfpoll(poll_list,pstream-poll_list,timeout);
 		for(i=0; i < pstream-poll_list; i++)
 			sfset(poll_list[i],SFIO_WRITE,1);
-		if(nready<=0)
+		if(n<=0)
 			return errno? -1: 0;
-		if(special && poll_list[0]==special)
+		for(hit=i=0; i < n; i++)
 		{
-			ready = 1;
-			return fd;
+			if(special && poll_list[i]==special)
+				hit = 1;
+			else
+				fdqueue(sffileno(poll_list[i]));
 		}
+		if(hit)
+			return fd;
 	}
 }
 
 static int service_init(void)
 {
-	int n = 20;
-	file_list = (int*)sh_newof(NULL,short,n,0);
-	poll_list = sh_newof(NULL,Sfio_t*,n,0);
-	service_list = sh_newof(NULL,Service_t*,n,0);
+	fdgrow(0);
+#if _use_epoll
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+#endif
 	covered_fdnotify = sh_fdnotify(fdnotify);
 	sh_waitnotify(waitnotify);
 	return 1;
@@ -272,8 +486,7 @@ void service_add(Service_t *sp)
 	static int init;
 	if (!init)
 		init = service_init();
-	service_list[sp->fd] = sp;
-	file_list[npoll++] = sp->fd;
+	fdwatch(sp,sp->fd);
 }
 
 static int Accept(Service_t *sp, int accept_fd)
@@ -281,23 +494,23 @@ static int Accept(Service_t *sp, int accept_fd)
 	Namval_t*	nq = sp->disc[ACCEPT];
 	int		fd;
 
-	fd = fcntl(accept_fd, F_DUPFD, 10);
-	if (fd >= 0)
-	{
+	/* keep the connection where it is if no descriptor above 9 is free */
+	if (accept_fd < 10 && (fd = fcntl(accept_fd, F_DUPFD, 10)) >= 0)
 		close(accept_fd);
-		if (nq)
-		{
-			char*	av[3];
-			char	buff[20];
+	else
+		fd = accept_fd;
+	if (nq)
+	{
+		char*	av[3];
+		char	buff[20];
 
-			av[1] = buff;
-			av[2] = 0;
-			sfsprintf(buff, sizeof(buff), "%d", fd);
-			if (sh_fun(nq, sp->node, av))
-			{
-				close(fd);
-				return -1;
-			}
+		av[1] = buff;
+		av[2] = 0;
+		sfsprintf(buff, sizeof(buff), "%d", fd);
+		if (sh_fun(nq, sp->node, av))
+		{
+			close(fd);
+			return -1;
 		}
 	}
 	sfsync(NULL);
@@ -378,11 +591,14 @@ static void putval(Namval_t* np, const char* val, int flag, Namfun_t* fp)
 	if (!val)
 	{
 		int i;
-		for(i=0; i< sh.lim.open_max; i++)
+		if(sp==active)
+			active = 0;
+		for(i=0; i < nfiles; i++)
 		{
 			if(service_list[i]==sp)
 			{
-				close(i);
+				fdunwatch(i);
+				sh_close(i);
 				if(--sp->refcount<=0)
 					break;
 			}
@@ -449,6 +665,7 @@ int	b_mkservice(int argc, char** argv, Shbltin_t *context)
 		close(fd);
 	else
 		sp->fd = fd;
+	fcntl(sp->fd, F_SETFL, fcntl(sp->fd,F_GETFL,0)|O_NONBLOCK);
 	np = nv_open(var,sh.var_tree,NV_ARRAY|NV_VARNAME);
 	sp->node = np;
 	nv_putval(np, path, 0);
@@ -460,6 +677,7 @@ int	b_mkservice(int argc, char** argv, Shbltin_t *context)
 int	b_eloop(int argc, char** argv, Shbltin_t *context)
 {
 	long	timeout = -1;
+	int	n;
 	NOT_USED(argc);
 	NOT_USED(context);
 	for (;;)
@@ -486,13 +704,14 @@ int	b_eloop(int argc, char** argv, Shbltin_t *context)
 		error(ERROR_usage(2), optusage(NULL));
 		UNREACHABLE();
 	}
-	while(1)
+	while((n = waitnotify(-1, timeout, 0)) != 0)
 	{
-		if(waitnotify(-1, timeout, 0)==0)
+		if(errno!=EINTR || (sh.trapnote&SH_SIGSET))
 			break;
-		sfprintf(sfstderr,"interrupted\n");
+		/* run any traps and timers, such as those set by alarm, that interrupted the wait */
+		sh_chktrap();
 	}
-	return errno != 0;
+	return n != 0;
 }
 
 #else
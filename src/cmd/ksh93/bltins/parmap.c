@@ -0,0 +1,297 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+/*
+ * parmap [-j jobs] [-n count] [-w] cmd [arg ...]
+ *
+ * Runs cmd on the lines (or words) read from standard input with up to
+ * <jobs> worker processes. The standard output of every worker goes to
+ * a pipe that is drained into a per-invocation buffer, and the buffers
+ * are written out in input order as soon as all earlier ones are done.
+ */
+
+#include	"shopt.h"
+#include	"defs.h"
+#include	"builtins.h"
+#include	"jobs.h"
+#include	"io.h"
+#include	"shnodes.h"
+#include	"variables.h"
+
+struct pmjob
+{
+	struct pmjob	*next;
+	Sfio_t		*in;		/* worker output pipe, NULL after EOF */
+	Sfio_t		*out;		/* collected worker output */
+	pid_t		pid;
+	int		fd;
+	int		exitval;
+};
+
+struct pminput
+{
+	Sfio_t		*iop;
+	char		*line;		/* current line for -w */
+	char		*next;		/* next word in line */
+	int		words;
+};
+
+static char *pm_dup(const char *cp, size_t n)
+{
+	char *dp = sh_malloc(n+1);
+	memcpy(dp,cp,n);
+	dp[n] = 0;
+	return dp;
+}
+
+/*
+ * return the next input item in malloc'ed space or NULL at end of input
+ */
+static char *pm_item(struct pminput *ip)
+{
+	char	*cp;
+	ssize_t	n;
+	while(1)
+	{
+		if(cp = ip->next)
+		{
+			while(isspace(*cp))
+				cp++;
+			if(*cp)
+			{
+				for(ip->next=cp; *ip->next && !isspace(*ip->next); ip->next++);
+				return pm_dup(cp,ip->next-cp);
+			}
+			ip->next = 0;
+		}
+		if(!(cp = sfgetr(ip->iop,'\n',0)) && !(cp = sfgetr(ip->iop,'\n',-1)))
+			return NULL;
+		if((n = sfvalue(ip->iop)) > 0 && cp[n-1]=='\n')
+			n--;
+		if(!ip->words)
+			return pm_dup(cp,n);
+		free(ip->line);
+		ip->next = ip->line = pm_dup(cp,n);
+	}
+}
+
+/*
+ * worker process: run argv with standard output to fd and exit
+ */
+static noreturn void pm_child(int fd, int argc, char *argv[])
+{
+	struct checkpt	*buffp = stkalloc(sh.stk,sizeof(struct checkpt));
+	struct comnod	*t = stkalloc(sh.stk,sizeof(struct comnod));
+	struct dolnod	*dp;
+	sh_invalidate_rand_seed();
+	sh_pushcontext(buffp,SH_JMPEXIT);
+	if(!sigsetjmp(buffp->buff,0))
+	{
+		sh_iorenumber(fd,1);
+		sh_close(fd);
+		if(sh_close(0)>=0)
+			sh_chkopen(e_devnull);
+		job_clear();
+		memset(t, 0, sizeof(struct comnod));
+		dp = stkalloc(sh.stk, (unsigned)sizeof(struct dolnod) + ARG_SPARE*sizeof(char*) + argc*sizeof(char*));
+		dp->dolnum = argc;
+		dp->dolbot = ARG_SPARE;
+		memcpy(dp->dolval+ARG_SPARE, argv, (argc+1)*sizeof(char*));
+		t->comarg.dp = dp;
+		if(!strchr(argv[0],'/'))
+			t->comnamp = nv_bfsearch(argv[0],sh.fun_tree,(Namval_t**)&t->comnamq,NULL);
+		/* the worker exits after this command, so an external command is exec'ed without forking again */
+		sh_exec((Shnode_t*)t,sh_isstate(SH_ERREXIT)|sh_state(SH_NOFORK)|sh_state(SH_FORKED));
+	}
+	sh_popcontext(buffp);
+	sh_done(0);
+}
+
+/*
+ * close the output pipe of a worker and wait for it to finish
+ */
+static void pm_reap(struct pmjob *jp)
+{
+	sfsetfd(jp->in,-1);
+	sfclose(jp->in);
+	sh_close(jp->fd);
+	jp->in = 0;
+	job_wait(jp->pid);
+	jp->exitval = sh.exitval;
+}
+
+/*
+ * create the output pipe of a worker and fork it to run argv
+ * returns the process ID, or -1 if sh_pipe() or sh_fork() raised an
+ * error, with *jmpval set to how it jumped and the pipe closed
+ */
+static pid_t pm_fork(int argc, char *argv[], int pv[], int *jmpval)
+{
+	struct checkpt	*buffp = stkalloc(sh.stk,sizeof(struct checkpt));
+	pid_t		pid = -1;
+	pv[0] = pv[1] = -1;
+	sh_pushcontext(buffp,SH_JMPCMD);
+	if(!(*jmpval = sigsetjmp(buffp->buff,0)))
+	{
+		sh_pipe(pv);
+		sh_fcntl(pv[0],F_SETFD,FD_CLOEXEC);
+		if((pid = sh_fork(0,NULL))==0)
+		{
+			sh_close(pv[0]);
+			pm_child(pv[1],argc,argv);
+		}
+	}
+	sh_popcontext(buffp);
+	if(*jmpval)
+	{
+		if(pv[0]>=0)
+			sh_close(pv[0]);
+		if(pv[1]>=0)
+			sh_close(pv[1]);
+		return -1;
+	}
+	return pid;
+}
+
+int	b_parmap(int argc,char *argv[],Shbltin_t *context)
+{
+	struct pminput	input;
+	struct pmjob	*first=0, *last=0, *jp;
+	Sfio_t		**poll_list;
+	char		**av, *cp;
+	long		njobs=0, count=1;
+	pid_t		pid;
+	int		n, nfixed, running=0, eof=0, exitval=0, jmpval=0, pv[2];
+	int		was_monitor = sh_isstate(SH_MONITOR);
+	NOT_USED(context);
+	memset(&input,0,sizeof(input));
+	while((n = optget(argv,sh_optparmap))) switch(n)
+	{
+	    case 'j':
+		njobs = opt_info.num;
+		break;
+	    case 'n':
+		count = opt_info.num;
+		break;
+	    case 'w':
+		input.words = 1;
+		break;
+	    case ':':
+		errormsg(SH_DICT,2, "%s", opt_info.arg);
+		break;
+	    case '?':
+		errormsg(SH_DICT,ERROR_usage(2), "%s", opt_info.arg);
+		UNREACHABLE();
+	}
+	argv += opt_info.index;
+	if(error_info.errors || !*argv || njobs<0 || count<1)
+	{
+		errormsg(SH_DICT,ERROR_usage(2),"%s",optusage(NULL));
+		UNREACHABLE();
+	}
+	if(njobs==0 && (njobs = strtol(astconf("NPROCESSORS_ONLN",NULL,NULL),NULL,0)) < 1)
+		njobs = 1;
+	if(!(input.iop=sh.sftable[0]) && !(input.iop=sh_iostream(0)))
+		return 1;
+	for(nfixed=0; argv[nfixed]; nfixed++);
+	poll_list = (Sfio_t**)stkalloc(sh.stk,njobs*sizeof(Sfio_t*));
+	av = (char**)stkalloc(sh.stk,(nfixed+count+1)*sizeof(char*));
+	memcpy(av,argv,nfixed*sizeof(char*));
+	/* workers share the shell's process group, so they are never job-controlled individually */
+	sh_offstate(SH_MONITOR);
+	while(1)
+	{
+		/* start workers until the limit is reached */
+		while(running<njobs && !eof && !(sh.trapnote&SH_SIGSET))
+		{
+			for(n=nfixed; n<nfixed+count && (cp=pm_item(&input)); n++)
+				av[n] = cp;
+			av[n] = 0;
+			if(n==nfixed)
+			{
+				eof = 1;
+				break;
+			}
+			if((pid = pm_fork(n,av,pv,&jmpval)) < 0)
+			{
+				/* out of file descriptors or processes; finish the workers already running */
+				while(--n>=nfixed)
+					free(av[n]);
+				eof = 1;
+				exitval = 1;
+				break;
+			}
+			sh_close(pv[1]);
+			jp = sh_newof(0,struct pmjob,1,0);
+			jp->pid = pid;
+			jp->in = sfnew(NULL,NULL,SFIO_UNBOUND,jp->fd=pv[0],SFIO_READ);
+			jp->out = sfstropen();
+			if(last)
+				last->next = jp;
+			else
+				first = jp;
+			last = jp;
+			running++;
+			while(--n>=nfixed)
+				free(av[n]);
+		}
+		/* write the output of finished invocations in input order */
+		while((jp=first) && !jp->in)
+		{
+			if((n = sfstrtell(jp->out)) > 0)
+				sfwrite(sfstdout,sfstrbase(jp->out),n);
+			sfstrclose(jp->out);
+			if(jp->exitval > exitval)
+				exitval = jp->exitval;
+			if(!(first = jp->next))
+				last = 0;
+			free(jp);
+		}
+		if(!running)
+			break;
+		/* collect output from workers that have some ready */
+		for(n=0, jp=first; jp; jp=jp->next)
+			if(jp->in)
+				poll_list[n++] = jp->in;
+		if((n = sfpoll(poll_list,n,-1)) < 0 && errno!=EINTR)
+		{
+			/* polling will keep failing; stop starting workers and wait for the running ones */
+			errormsg(SH_DICT,ERROR_system(0),"cannot poll worker output");
+			eof = 1;
+			exitval = 1;
+			for(jp=first; jp; jp=jp->next)
+				if(jp->in)
+				{
+					pm_reap(jp);
+					running--;
+				}
+			continue;
+		}
+		while(--n >= 0)
+		{
+			for(jp=first; jp->in!=poll_list[n]; jp=jp->next);
+			if((cp = sfreserve(jp->in,SFIO_UNBOUND,0)) && sfvalue(jp->in) > 0)
+				sfwrite(jp->out,cp,sfvalue(jp->in));
+			else
+			{
+				pm_reap(jp);
+				running--;
+			}
+		}
+	}
+	if(was_monitor && sh_isoption(SH_MONITOR))
+		sh_onstate(SH_MONITOR);
+	free(input.line);
+	if(jmpval>SH_JMPCMD)
+		siglongjmp(*sh.jmplist,jmpval);
+	return exitval;
+}
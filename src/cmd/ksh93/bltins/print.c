@@ -33,6 +33,7 @@
 #include	"history.h"
 #include	"builtins.h"
 #include	"streval.h"
+#include	"national.h"
 #include	<tmx.h>
 
 union types_t
@@ -62,6 +63,32 @@ struct printf
 	char		err;
 };
 
+/*
+ * A format compiled by fmtcompile() into a list of literal text parts and
+ * simple conversions that fmtrun() can execute without sfprintf() parsing
+ * the format again for each record. All offsets are relative to the start
+ * of the plan, so that a plan can be copied to the stack and run from there.
+ */
+struct fmtpart
+{
+	int		type;	/* conversion character, or 0 for literal text */
+	int		flags;	/* SFFMT_ALTER if the '#' flag was given */
+	int		plain;	/* no flags, width or precision */
+	int		off;	/* offset of literal text or conversion prefix */
+	int		len;	/* length of literal text or conversion prefix */
+};
+
+struct fmtplan
+{
+	size_t		size;	/* total size of the plan in bytes */
+	int		form;	/* offset of the format after escape processing */
+	int		nparts;	/* number of parts, or -1 to use sfprintf() */
+	struct fmtpart	part[1];
+};
+
+#define FMTCACHE	16	/* number of compiled formats kept */
+#define FMTSPARE	4	/* bytes reserved after each conversion prefix */
+
 struct printmap
 {
 	size_t		size;
@@ -85,8 +112,11 @@ static int		echolist(Sfio_t*, int, char**);
 static int		extend(Sfio_t*,void*, Sffmt_t*);
 static int		reload(int argn, char fmt, void* v, Sffmt_t* fe);
 static char		*genformat(char*);
+static struct fmtplan	*fmtplan(char*);
+static void		fmtrun(Sfio_t*, struct fmtplan*, struct printf*);
 static int		fmtvecho(const char*, struct printf*);
 static ssize_t		fmtbase64(Sfio_t*, char*, int);
+static int		fmtjson(Sfio_t*, char*);
 struct print
 {
 	const char	*options;
@@ -176,6 +206,7 @@ int    b_print(int argc, char *argv[], Shbltin_t *context)
 #endif /* !SHOPT_SCRIPTONLY */
 	int nflag=0, rflag=0, vflag=0;
 	Namval_t *vname=0;
+	struct fmtplan *plan = 0;
 	Optdisc_t disc;
 	exitval = 0;
 	memset(&disc, 0, sizeof(disc));
@@ -274,6 +305,9 @@ int    b_print(int argc, char *argv[], Shbltin_t *context)
 		case 'C':
 			vflag='C';
 			break;
+		case 'j':
+			vflag='j';
+			break;
 		case ':':
 #if SHOPT_PRINTF_LEGACY
 			/* POSIX-ignorant printf(1) compat, prong 2: treat erroneous first option as operand */
@@ -326,7 +360,9 @@ skipopts:
 		UNREACHABLE();
 	}
 skip:
-	if(format)
+	if(format && (plan = fmtplan(format)))
+		format = (char*)plan + plan->form;
+	else if(format)
 		format = genformat(format);
 	/* handle special case of '-' operand for print */
 	if(argc>0 && *argv && strcmp(*argv,"-")==0 && strcmp(argv[-1],"--"))
@@ -369,7 +405,7 @@ printf_v:
 	if(format)
 	{
 		/* printf style print */
-		Sfio_t *pool;
+		Sfio_t *pool = 0;
 		struct printf pdata;
 		memset(&pdata, 0, sizeof(pdata));
 		pdata.hdr.version = SFIO_VERSION;
@@ -377,19 +413,31 @@ printf_v:
 		pdata.hdr.reloadf = reload;
 		pdata.nextarg = argv;
 		sh_offstate(SH_STOPOK);
-		pool=sfpool(sfstderr,NULL,SFIO_WRITE);
+		/*
+		 * sfprintf() keeps outfile locked, so take standard error out of the
+		 * output pool for messages from extend(). A compiled format does not
+		 * need this, which saves flushing outfile when it is put back.
+		 */
+		if(!plan || plan->nparts < 0)
+			pool = sfpool(sfstderr,NULL,SFIO_WRITE);
 		do
 		{
 			pdata.argv0 = pdata.nextarg;
 			if(sh.trapnote&SH_SIGSET)
 				break;
-			pdata.hdr.form = format;
-			sfprintf(outfile,"%!",&pdata);
+			if(plan && plan->nparts >= 0)
+				fmtrun(outfile,plan,&pdata);
+			else
+			{
+				pdata.hdr.form = format;
+				sfprintf(outfile,"%!",&pdata);
+			}
 		} while(*pdata.nextarg && pdata.nextarg!=argv);
 		if(pdata.nextarg == nullarg && pdata.argsize>0)
 			if(sfwrite(outfile,stkptr(sh.stk,stktell(sh.stk)),pdata.argsize) < 0)
 				exitval = 1;
-		sfpool(sfstderr,pool,SFIO_WRITE);
+		if(pool)
+			sfpool(sfstderr,pool,SFIO_WRITE);
 		if (pdata.err)
 			exitval = 1;
 	}
@@ -397,7 +445,7 @@ printf_v:
 	{
 		while(*argv)
 		{
-			if(fmtbase64(outfile,*argv++,vflag=='C') < 0)
+			if(vflag=='j' ? fmtjson(outfile,*argv++) < 0 : fmtbase64(outfile,*argv++,vflag=='C') < 0)
 				exitval = 1;
 			if(!nflag)
 				if(sfputc(outfile,'\n') < 0)
@@ -429,7 +477,18 @@ printf_v:
 	{
 		if(n&SFIO_SHARE)
 			sfset(outfile,SFIO_SHARE|SFIO_PUBLIC,1);
-		if (sfsync(outfile) < 0)
+		/*
+		 * Standard output to a file or pipe is left in the buffer unless it
+		 * was redirected for this command only, or it is a pipe and SIGPIPE
+		 * is trapped or ignored so that print must report EPIPE itself. It
+		 * is written out when the shell forks, runs a command or a built-in
+		 * that is not BLT_ENV, blocks reading from a pipe or terminal, waits,
+		 * restores the redirection or exits, or when the buffer fills up.
+		 */
+		if(fd==1 && !(sh.fdstatus[1]&IOTTY) && sh.topfd==((struct checkpt*)sh.jmplist)->topfd
+		&& (!(sh.fdstatus[1]&IONOSEEK) || !(sh.sigflag[SIGPIPE]&(SH_SIGFAULT|SH_SIGOFF))))
+			;
+		else if (sfsync(outfile) < 0)
 			exitval = 1;
 	}
 	return exitval;
@@ -533,6 +592,201 @@ static char *genformat(char *format)
 	return fp;
 }
 
+/*
+ * Compile the escape-processed <form> into a plan in malloc'd memory.
+ * Only literal text, '%%' and conversions of the form %[-+ #0][width][.prec]c
+ * where c is one of the characters below are compiled; for any other format,
+ * the plan has nparts -1 and only keeps the escape-processed format.
+ */
+static struct fmtplan *fmtcompile(const char *form)
+{
+	struct fmtplan	*plan;
+	struct fmtpart	*pp;
+	const char	*cp, *lit, *sp;
+	char		*tp;
+	size_t		len = strlen(form), n = 0;
+	int		flags, nparts = 0;
+	for(cp=form; cp = strchr(cp,'%'); cp++)
+		n++;
+	len = sizeof(struct fmtplan) + 2*n*sizeof(struct fmtpart) + 2*(len+1) + n*FMTSPARE;
+	plan = sh_malloc(len);
+	plan->size = len;
+	pp = plan->part;
+	tp = (char*)&plan->part[2*n+1];
+	plan->form = tp - (char*)plan;
+	tp = strcopy(tp,form) + 1;
+#if SHOPT_MULTIBYTE
+	/* a '%' byte may be part of a character in other multibyte locales */
+	if(mbwide() && !mbutf8())
+		goto fallback;
+#endif /* SHOPT_MULTIBYTE */
+	for(cp=lit=form; *cp; )
+	{
+		if(*cp++ != '%')
+			continue;
+		/* for '%%', end the literal text after the first '%' */
+		sp = (*cp=='%') ? cp : cp - 1;
+		if(sp > lit)
+		{
+			pp->type = 0;
+			pp->off = tp - (char*)plan;
+			pp->len = sp - lit;
+			memcpy(tp,lit,pp->len);
+			tp += pp->len;
+			pp++;
+			nparts++;
+		}
+		if(sp==cp)
+		{
+			lit = ++cp;
+			continue;
+		}
+		flags = 0;
+		while(*cp=='-' || *cp=='+' || *cp==' ' || *cp=='#' || *cp=='0')
+			if(*cp++=='#')
+				flags = SFFMT_ALTER;
+		while(isdigit(*cp))
+			cp++;
+		if(*cp=='.')
+			while(isdigit(*++cp));
+		if(!*cp || !strchr("sqdiuoxXaAeEfFgG",*cp))
+			goto fallback;
+		pp->type = *cp;
+		pp->flags = flags;
+		pp->plain = (cp==sp+1);
+		pp->off = tp - (char*)plan;
+		pp->len = cp - sp;
+		memcpy(tp,sp,pp->len);
+		tp += pp->len + FMTSPARE;
+		pp++;
+		nparts++;
+		lit = ++cp;
+	}
+	if(cp > lit)
+	{
+		pp->type = 0;
+		pp->off = tp - (char*)plan;
+		pp->len = cp - lit;
+		memcpy(tp,lit,pp->len);
+		nparts++;
+	}
+	plan->nparts = nparts;
+	return plan;
+fallback:
+	plan->nparts = -1;
+	return plan;
+}
+
+/*
+ * Return a copy on the stack of the compiled plan for <format>.
+ * Plans are cached by format string and locale, so a format that is used
+ * repeatedly is only escape-processed and parsed once. The stack copy
+ * stays valid even if a nested printf (e.g., from an arithmetic function
+ * evaluating a numeric argument) evicts the plan from the cache.
+ */
+static struct fmtplan *fmtplan(char *format)
+{
+	static struct fmtcache
+	{
+		char		*format;
+		unsigned int	hash;
+		uint32_t	serial;
+		struct fmtplan	*plan;
+	}		cache[FMTCACHE];
+	static int	next;
+	struct fmtcache	*ep;
+	struct fmtplan	*plan;
+	unsigned int	hash = 0;
+	char		*s;
+	for(s=format; *s; s++)
+		hash = hash*33 + *(unsigned char*)s;
+	for(ep=cache; ep < &cache[FMTCACHE]; ep++)
+		if(ep->plan && ep->hash==hash && ep->serial==ast.locale.serial && strcmp(ep->format,format)==0)
+			break;
+	if(ep==&cache[FMTCACHE])
+	{
+		ep = &cache[next];
+		next = (next+1) % FMTCACHE;
+		if(ep->plan)
+		{
+			free(ep->plan);
+			free(ep->format);
+		}
+		ep->plan = fmtcompile(genformat(format));
+		ep->format = sh_strdup(format);
+		ep->hash = hash;
+		ep->serial = ast.locale.serial;
+	}
+	plan = stkalloc(sh.stk,ep->plan->size);
+	memcpy(plan,ep->plan,ep->plan->size);
+	return plan;
+}
+
+/*
+ * Execute one record of a compiled format plan, converting the arguments
+ * with extend() exactly as sfprintf() would when given the format
+ */
+static void fmtrun(Sfio_t *outfile, struct fmtplan *plan, struct printf *pp)
+{
+	struct fmtpart	*fp = plan->part, *end = fp + plan->nparts;
+	Sffmt_t		*fe = &pp->hdr;
+	union types_t	value;
+	char		*spec;
+	for(; fp < end; fp++)
+	{
+		spec = (char*)plan + fp->off;
+		if(!fp->type)
+		{
+			sfwrite(outfile,spec,fp->len);
+			continue;
+		}
+		fe->fmt = fp->type;
+		fe->flags = fp->flags;
+		fe->size = -1;
+		fe->base = -1;
+		fe->t_str = 0;
+		fe->n_str = 0;
+		extend(outfile,&value,fe);
+		switch(fe->fmt)
+		{
+		case 's':
+			if(fp->plain)
+				sfputr(outfile,value.s,-1);
+			else
+			{
+				memcpy(spec+fp->len,"s",2);
+				sfprintf(outfile,spec,value.s);
+			}
+			break;
+		case 'a':
+		case 'A':
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+			spec[fp->len] = 'L';
+			spec[fp->len+1] = fe->fmt;
+			spec[fp->len+2] = 0;
+			sfprintf(outfile,spec,value.ld);
+			break;
+		default:
+			if(fp->plain && fe->fmt=='d')
+				sfputr(outfile,fmtint(value.ll,0),-1);
+			else
+			{
+				spec[fp->len] = 'l';
+				spec[fp->len+1] = 'l';
+				spec[fp->len+2] = fe->fmt;
+				spec[fp->len+3] = 0;
+				sfprintf(outfile,spec,value.ll);
+			}
+			break;
+		}
+	}
+}
+
 static char *fmthtml(const char *string, int flags)
 {
 	const char *cp = string, *op;
@@ -594,6 +848,21 @@ static char *fmthtml(const char *string, int flags)
 	return stkptr(sh.stk,offset);
 }
 
+static int fmtjson(Sfio_t *iop, char *string)
+{
+	Namval_t	*np = nv_open(string, NULL, NV_VARNAME|NV_NOADD);
+	if(!np || nv_isnull(np) && !nv_isvtree(np) && !nv_arrayptr(np) && !nv_isarray(np))
+	{
+		if(sh_isoption(SH_NOUNSET))
+		{
+			errormsg(SH_DICT,ERROR_exit(1),e_notset,string);
+			UNREACHABLE();
+		}
+		return sfputr(iop,"null",-1);
+	}
+	return nv_outjson(np,iop);
+}
+
 static ssize_t fmtbase64(Sfio_t *iop, char *string, int alt)
 {
 	char			*cp;
@@ -45,8 +45,9 @@
 #define NN_FLAG	0x10	/* fixed size read exact */
 #define V_FLAG	0x20	/* use default value */
 #define C_FLAG	0x40	/* read into compound variable */
-#define D_FLAG	8	/* must be number of bits for all flags */
+#define D_FLAG	9	/* must be number of bits for all flags */
 #define SS_FLAG	0x80	/* read .csv format file */
+#define J_FLAG	0x100	/* read JSON into variable */
 
 struct read_save
 {
@@ -95,6 +96,9 @@ int	b_read(int argc,char *argv[], Shbltin_t *context)
 	    case 'C':
 		flags |= C_FLAG;
 		break;
+	    case 'j':
+		flags |= J_FLAG;
+		break;
 	    case 't':
 		sec = sh_strnum(opt_info.arg, NULL,1);
 		timeout = sec ? 1000*sec : 1;
@@ -205,6 +209,22 @@ static void timedout(void *handle)
 	sh_exit(1);
 }
 
+/*
+ * read a JSON value into variable <name>; standard input is shared
+ * as for a line so that nv_readjson() leaves the rest of it unread
+ */
+static int readjson(const char *name, Sfio_t *iop, int fd)
+{
+	int	r, was_share = 1;
+	sfclrerr(iop);
+	if(fd==0)
+		was_share = (sfset(iop,SFIO_SHARE,sh.redir0!=2)&SFIO_SHARE)!=0;
+	r = nv_readjson(name,iop);
+	if(!was_share)
+		sfset(iop,SFIO_SHARE,0);
+	return r;
+}
+
 /*
  * This is the code to read a line and to split it into tokens
  *  <names> is an array of variable names
@@ -246,6 +266,13 @@ int sh_readline(char **names, volatile int fd, int flags, ssize_t size, Sflong_t
 		Namval_t *mp;
 		if(val= strchr(name,'?'))
 			*val = 0;
+		if(flags&J_FLAG)
+		{
+			c = readjson(name,iop,fd);
+			if(val)
+				*val = '?';
+			return c;
+		}
 		/*
 		 * For -C to work, we need not only NV_ARRAY but also NV_ASSIGN. But an actual 'variable=value'
 		 * assignment-argument would be nonsense and crashes the shell if allowed, so avoid setting
@@ -289,6 +316,8 @@ int sh_readline(char **names, volatile int fd, int flags, ssize_t size, Sflong_t
 		if(val)
 			*val = '?';
 	}
+	else if(flags&J_FLAG)
+		return readjson(nv_name(REPLYNOD),iop,fd);
 	else
 	{
 		name = 0;
@@ -40,6 +40,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include	"defs.h"
 #include	<error.h>
 #include	"path.h"
@@ -200,7 +201,10 @@ int    b_alias(int argc,char *argv[],Shbltin_t *context)
 			tdata.aflag = '-';		/* make setall() treat 'hash' like 'alias -t' */
 		}
 		if(rflag)				/* hash -r: clear hash table */
+		{
 			nv_scan(troot,nv_rehash,NULL,NV_TAGGED,NV_TAGGED);
+			path_compreset();
+		}
 	}
 	return setall(argv,flag,troot,&tdata);
 }
@@ -1625,6 +1629,8 @@ static void print_scan(Sfio_t *file, int flag, Dt_t *root, int option,struct tda
 	namec = nv_scan(root, pushname, tp, tp->scanmask, flag&~NV_IARRAY);
 	if(mbcoll())
 		strsort(argv,namec,strcoll);
+	else if(!(root->meth->type&DT_ORDERED))
+		strsort(argv,namec,strcmp);	/* hash table, e.g. tracked aliases */
 	if(namec==0 && sh.namespace && nv_dict(sh.namespace)==root)
 	{
 		sfnputc(file,'\t',tp->indent);
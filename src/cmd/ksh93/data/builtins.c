@@ -107,6 +107,7 @@ const struct shtable3 shtab_builtins[] =
 	"suspend", 	NV_BLTIN|BLT_ENV,		bltin(suspend),
 	"false",	NV_BLTIN|BLT_ENV,		bltin(false),
 	"getopts",	NV_BLTIN|BLT_ENV,		bltin(getopts),
+	"parmap",	NV_BLTIN|BLT_ENV,		bltin(parmap),
 #if SHOPT_MKSERVICE
 	"mkservice",	NV_BLTIN|BLT_ENV,		bltin(mkservice),
 	"eloop",	NV_BLTIN|BLT_ENV,		bltin(eloop),
@@ -118,6 +119,7 @@ const struct shtable3 shtab_builtins[] =
 	"sleep",	NV_BLTIN,			bltin(sleep),
 	"alarm",	NV_BLTIN|BLT_ENV,		bltin(alarm),
 	"times",	NV_BLTIN|BLT_ENV|BLT_SPC,	bltin(times),
+	"tracebuf",	NV_BLTIN|BLT_ENV,		bltin(tracebuf),
 	"ulimit",	NV_BLTIN|BLT_ENV,		bltin(ulimit),
 	"umask",	NV_BLTIN|BLT_ENV,		bltin(umask),
 #if _cmd_universe
@@ -1197,8 +1199,37 @@ const char sh_optlet[]	=
 "[+SEE ALSO?\bexpr\b(1), \btest\b(1), \bksh\b(1)]"
 ;
 
+const char sh_optparmap[] =
+"[-1c?\n@(#)$Id: parmap (ksh 93u+m) 2026-10-19 $\n]"
+"[--catalog?" SH_DICT "]"
+"[+NAME?parmap - run a command in parallel on lines or words from standard input]"
+"[+DESCRIPTION?\bparmap\b reads lines from standard input and invokes "
+	"\acmd\a with the given \aarg\as followed by one or more of those "
+	"lines as additional arguments. Up to \ajobs\a invocations run at the "
+	"same time, each in a separate process. \acmd\a may be a built-in "
+	"command, a shell function or an external command.]"
+"[+?The standard output of each invocation is collected by the shell and "
+	"written to the standard output of \bparmap\b in input order, "
+	"regardless of the order in which the invocations complete. "
+	"Standard error is not collected. Each invocation reads its "
+	"standard input from \b/dev/null\b.]"
+"[j]#[jobs?Run at most \ajobs\a invocations at the same time. "
+	"The default is the number of online processors.]"
+"[n]#[count?Pass at most \acount\a input items to each invocation. "
+	"The default is \b1\b.]"
+"[w?Split each input line into words separated by white space and "
+	"use those as the input items.]"
+"\n"
+"\ncmd [arg ...]\n"
+"\n"
+"[+EXIT STATUS?The highest exit status of all the \acmd\a invocations, "
+	"or \b0\b if standard input was empty.]"
+
+"[+SEE ALSO?\bcommand\b(1), \bxargs\b(1)]"
+;
+
 const char sh_optprint[] =
-"[-1c?\n@(#)$Id: print (ksh 93u+m) 2022-09-26 $\n]"
+"[-1c?\n@(#)$Id: print (ksh 93u+m) 2026-10-19 $\n]"
 "[--catalog?" SH_DICT "]"
 "[+NAME?print - write arguments to standard output]"
 "[+DESCRIPTION?By default, \bprint\b writes each \astring\a operand to "
@@ -1245,6 +1276,10 @@ const char sh_optprint[] =
 	"format. Cannot be used with \b-f\b.]"
 "[C?Treat each \astring\a as a variable name and write the value in \b%#B\b "
 	"format. Cannot be used with \b-f\b.]"
+"[j?Treat each \astring\a as a variable name and write the value as JSON. "
+	"Compound variables and associative arrays are written as objects, "
+	"indexed arrays as arrays, variables with a numeric attribute as "
+	"numbers and other variables as strings. Cannot be used with \b-f\b.]"
 "\n"
 "\n[string ...]\n"
 "\n"
@@ -1454,7 +1489,7 @@ const char sh_optpwd[] =
 ;
 
 const char sh_optread[] =
-"[-1c?\n@(#)$Id: read (ksh 93u+m) 2023-03-24 $\n]"
+"[-1c?\n@(#)$Id: read (ksh 93u+m) 2026-10-19 $\n]"
 "[--catalog?" SH_DICT "]"
 "[+NAME?read - read a line from standard input]"
 "[+DESCRIPTION?\bread\b reads a line from standard input and breaks it "
@@ -1479,6 +1514,11 @@ const char sh_optread[] =
 "[A|a?Unset \avar\a and then create an indexed array containing each field in "
 	"the line starting at index 0.]"
 "[C?Unset \avar\a and read  \avar\a as a compound variable.]"
+"[j?Unset \avar\a and read one JSON value into it. Objects become compound "
+	"variables, arrays become indexed arrays, numbers get the \b-li\b or "
+	"\b-lE\b attribute, \btrue\b and \bfalse\b become strings and "
+	"members or elements that are \bnull\b are left unset. Blanks after "
+	"the value and the newline that ends its line are skipped.]"
 "[d]:[delim?Read until delimiter \adelim\a instead of to the end of line.]"
 "[n]#[count?Read at most \acount\a characters or (for binary fields) bytes."
 #if _pipe_socketpair
@@ -2023,6 +2063,46 @@ const char sh_opttimes[] =
 "[+SEE ALSO?\btime\b(1)]"
 ;
 
+const char sh_opttracebuf[] =
+"[-1c?\n@(#)$Id: tracebuf (ksh 93u+m) 2026-10-19 $\n]"
+"[--catalog?" SH_DICT "]"
+"[+NAME?tracebuf - record an execution trace in memory]"
+"[+DESCRIPTION?\btracebuf\b controls a buffer in which the shell records "
+	"a fixed-size binary event each time a simple command starts or "
+	"ends and each time a function is called or returns. Each event "
+	"holds a monotonic timestamp with nanosecond resolution, the process "
+	"ID, the line number, the function nesting depth, the first 40 "
+	"bytes of the command or function name and, for end and return "
+	"events, the exit status. Recording costs little more than storing "
+	"the event; when the buffer is full, the oldest event is "
+	"overwritten.]"
+"[+?Without options, \btracebuf\b writes the recorded events to standard "
+	"output as a timeline, oldest first. Each line shows the time of "
+	"day with microseconds, the process ID in brackets, the line number, "
+	"and the event indented by the nesting depth. End and return events "
+	"also show the exit status and the time elapsed since the "
+	"matching start or call.]"
+"[+?To keep the trace of a failing script or one that is killed, use "
+	"\btrap\b to write the buffer at exit or on a signal, for instance "
+	"\btrap 'tracebuf -w /tmp/trace.$$' EXIT USR1\b. The events "
+	"recorded in a subshell or child process are not seen by the parent "
+	"shell.]"
+"[c?Discard the recorded events.]"
+"[n]#[count?Record the last \acount\a events from now on, discarding "
+	"those recorded earlier unless \acount\a is the current size. A "
+	"\acount\a of 0 stops recording and frees the buffer. The maximum "
+	"is 1048576.]"
+"[r]:[file?Write the timeline of the events in \afile\a, which must have "
+	"been written by \btracebuf -w\b, to standard output.]"
+"[w]:[file?Write the recorded events to \afile\a in binary form. This is "
+	"done before the \b-c\b and \b-n\b options take effect.]"
+"[+EXIT STATUS?]{"
+	"[+0?Successful completion.]"
+	"[+>0?An error occurred.]"
+"}"
+"[+SEE ALSO?\bset\b(1), \btrap\b(1)]"
+;
+
 const char sh_optumask[] =
 "[-1c?\n@(#)$Id: umask (AT&T Research) 1999-04-07 $\n]"
 "[--catalog?" SH_DICT "]"
@@ -97,6 +97,7 @@ const struct shtable2 shtab_variables[] =
 	".sh.level",	NV_INT16|NV_NOFREE|NV_RDONLY,	NULL,
 	".sh.lineno",	NV_INTEGER|NV_NOFREE,		NULL,
 	".sh.stats",	0,				NULL,
+	".sh.mem",	0,				NULL,
 	".sh.math",	0,				NULL,
 	".sh.pid",	NV_PID|NV_NOFREE,		NULL,
 	".sh.ppid",	NV_PID|NV_NOFREE,		NULL,
@@ -124,7 +125,37 @@ const Shtable_t shtab_stats[] =
 	"posixfuncall",		STAT_SVFUNCT,
 	"simplecmds",		STAT_SCMDS,
 	"spawns",		STAT_SPAWN,
-	"subshell",		STAT_SUBSHELL
+	"subshell",		STAT_SUBSHELL,
+	"startup_usec",		STAT_STARTUP,
+	"startup_context",	STAT_STCONTEXT,
+	"startup_names",	STAT_STNAMES,
+	"startup_env",		STAT_STENV,
+	"startup_options",	STAT_STOPTIONS,
+	"startup_locale",	STAT_STLOCALE,
+	"startup_profile",	STAT_STPROFILE,
+	"heredoc_memfd",	STAT_HEREMEM,
+	"heredoc_tmpfile",	STAT_HERETMP
+};
+
+/* indices are into the counters kept by sh_mallocx() etc. in init.c */
+const Shtable_t shtab_mem[] =
+{
+	"arrays_allocs",	MEM_STAT(MEM_ARRAYS,MEM_ALLOCS),
+	"arrays_bytes",		MEM_STAT(MEM_ARRAYS,MEM_BYTES),
+	"funcs_allocs",		MEM_STAT(MEM_FUNCS,MEM_ALLOCS),
+	"funcs_bytes",		MEM_STAT(MEM_FUNCS,MEM_BYTES),
+	"history_allocs",	MEM_STAT(MEM_HIST,MEM_ALLOCS),
+	"history_bytes",	MEM_STAT(MEM_HIST,MEM_BYTES),
+	"io_allocs",		MEM_STAT(MEM_IO,MEM_ALLOCS),
+	"io_bytes",		MEM_STAT(MEM_IO,MEM_BYTES),
+	"other_allocs",		MEM_STAT(MEM_OTHER,MEM_ALLOCS),
+	"other_bytes",		MEM_STAT(MEM_OTHER,MEM_BYTES),
+	"parse_allocs",		MEM_STAT(MEM_PARSE,MEM_ALLOCS),
+	"parse_bytes",		MEM_STAT(MEM_PARSE,MEM_BYTES),
+	"stk_inuse",		MEM_STAT(MEM_NTAGS,0),
+	"stk_peak",		MEM_STAT(MEM_NTAGS,1),
+	"vars_allocs",		MEM_STAT(MEM_VARS,MEM_ALLOCS),
+	"vars_bytes",		MEM_STAT(MEM_VARS,MEM_BYTES)
 };
 #endif /* SHOPT_STATS */
 
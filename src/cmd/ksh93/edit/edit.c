@@ -47,6 +47,8 @@
 #if SHOPT_ESH || SHOPT_VSH
 static char *cursor_up;  /* move cursor up one line */
 static char *erase_eos;  /* erase to end of screen */
+static char *insert_char;  /* insert one blank at the cursor */
+static char *delete_char;  /* delete the character at the cursor */
 #endif /*  SHOPT_ESH || SHOPT_VSH */
 
 #if SHOPT_MULTIBYTE
@@ -509,6 +511,15 @@ void	ed_setup(Edit_t *ep, int fd, int reedit)
 				get_tput(TCAP_CURSOR_UP,&cursor_up);
 			if(!erase_eos)
 				get_tput(TCAP_ERASE_EOS,&erase_eos);
+			if(cursor_up && erase_eos)
+			{
+				get_tput(TINF_INSERT_CHAR,&insert_char);
+				get_tput(TINF_DELETE_CHAR,&delete_char);
+				if(!insert_char)
+					get_tput(TCAP_INSERT_CHAR,&insert_char);
+				if(!delete_char)
+					get_tput(TCAP_DELETE_CHAR,&delete_char);
+			}
 			if(oldterm)
 				free(oldterm);
 			oldterm = sh_strdup(term);
@@ -1090,6 +1101,84 @@ int ed_setcursor(Edit_t *ep,genchar *physical,int old,int new,int first)
 }
 #endif /* SHOPT_ESH || SHOPT_VSH */
 
+#if SHOPT_ESH || SHOPT_VSH
+/*
+ * Update the screen image <screen> of <olen> cells to the new image <nscr>
+ * of <nlen> cells if the two differ only by one run of inserted or deleted
+ * cells and inserting or deleting them on the terminal is cheaper than
+ * rewriting the rest of the line. Only done for a line that fits on the
+ * first row in multiline mode, as the terminal does not move characters
+ * across rows. <cur> and <first> are as for ed_setcursor().
+ * Returns the new cursor position, or -1 with no output if not done.
+ */
+int ed_shift(Edit_t *ep, genchar *screen, int cur, int olen, const genchar *nscr, int nlen, int first)
+{
+	const genchar	*run;
+	char		*cp;
+	int		pos, k, n, len=nlen;
+	if(!ep->e_multiline || !insert_char || !delete_char)
+		return -1;
+	while(olen>0 && (screen[olen-1]==' ' || screen[olen-1]==0))
+		olen--;
+	while(nlen>0 && (nscr[nlen-1]==' ' || nscr[nlen-1]==0))
+		nlen--;
+	if((k = nlen-olen)==0 || ep->e_plen+(k>0?nlen:olen) >= ep->e_winsz)
+		return -1;
+	for(pos=0; pos<olen && pos<nlen && screen[pos]==nscr[pos]; pos++);
+#if SHOPT_MULTIBYTE
+	/* do not split a wide character */
+	while(pos>0 && (pos<olen && screen[pos]==MARKER || pos<nlen && nscr[pos]==MARKER))
+		pos--;
+#endif /* SHOPT_MULTIBYTE */
+	if(k>0)
+	{
+		cp = insert_char;
+		n = nlen-pos;
+		run = nscr;
+		if(k*(strlen(cp)+1) >= n || memcmp(screen+pos,nscr+pos+k,(olen-pos)*sizeof(genchar)))
+			return -1;
+	}
+	else
+	{
+		k = -k;
+		cp = delete_char;
+		n = olen-pos;
+		run = screen;
+		if(k*strlen(cp) >= n || memcmp(screen+pos+k,nscr+pos,(nlen-pos)*sizeof(genchar)))
+			return -1;
+	}
+#if SHOPT_MULTIBYTE
+	/* the run must take up one column per cell */
+	for(n=pos; n<pos+k; n++)
+	{
+		if(run[n]!=MARKER && mbwidth(run[n])<1)
+			return -1;
+	}
+#else
+	NOT_USED(run);
+#endif /* SHOPT_MULTIBYTE */
+	ed_setcursor(ep,screen,cur,pos,first);
+	for(n=k; n>0; n--)
+		ed_putstring(ep,cp);
+	if(run==nscr)
+	{
+		memmove(screen+pos+k,screen+pos,(olen-pos)*sizeof(genchar));
+		for(n=pos; n<pos+k; n++)
+			ed_putchar(ep,screen[n]=nscr[n]);
+		cur = pos+k;
+	}
+	else
+	{
+		memmove(screen+pos,screen+pos+k,(nlen-pos)*sizeof(genchar));
+		cur = pos;
+	}
+	while(nlen<len)
+		screen[nlen++] = ' ';
+	screen[nlen] = 0;
+	return cur;
+}
+#endif /* SHOPT_ESH || SHOPT_VSH */
+
 #if SHOPT_ESH || SHOPT_VSH
 /*
  * copy virtual to physical and return the index for cursor in physical buffer
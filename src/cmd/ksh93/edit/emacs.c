@@ -1474,6 +1474,14 @@ static void draw(Emacs_t *ep,Draw_t option)
 	**********************/
 
 	i = ncursor - nscreen;
+	if (ep->offset==0 && ep->overflow==NORMAL && nscend < &nscreen[w_size] && i < w_size)
+	{
+		/* the screen need not scroll, so try to shift the rest of the line */
+		for (sptr = ep->screen; sptr < &ep->screen[w_size] && *sptr; sptr++);
+		if ((i = ed_shift(ep->ed,ep->screen,ep->cursor-ep->screen,sptr-ep->screen,nscreen,nscend+1-nscreen,0)) >= 0)
+			ep->cursor = ep->screen + i;
+		i = ncursor - nscreen;
+	}
 	if ((ep->offset && i<=ep->offset)||(i >= (ep->offset+w_size)))
 	{
 		/* Center the cursor on the screen */
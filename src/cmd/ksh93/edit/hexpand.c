@@ -32,6 +32,7 @@
 
 
 #include "shopt.h"
+#define MEM_TAG	MEM_HIST
 #include "defs.h"
 #include "edit.h"
 
@@ -53,6 +53,8 @@
 #define HIST_CMDNO	0202		/* next 3 bytes give command number */
 #define HIST_BSIZE	4096		/* size of history file buffer */
 #define HIST_DFLT	512		/* default size of history list */
+#define HIST_MAPMIN	(16*HIST_BSIZE)	/* map file for hist_eof() from this size */
+#define HIST_MAPMAX	(1L<<30)	/* max size mapped at once */
 
 #if SHOPT_AUDIT
 #   define _HIST_AUDIT	Sfio_t	*auditfp; \
@@ -69,6 +71,8 @@
 	int	histmask;	/* power of two mask for histcnt */ \
 	char	histbuff[HIST_BSIZE+1];	/* history file buffer */ \
 	int	histwfail; \
+	int	histsync;	/* set if other shells appended to the file */ \
+	struct Histidx	*histidx;	/* search index, see hidx_get() */ \
 	_HIST_AUDIT \
 	off_t	histcmds[2];	/* offset for recent commands, must be last */
 
@@ -76,8 +80,10 @@
 
 #include	<sfio.h>
 #include	"FEATURE/time"
+#include	"FEATURE/externs"
 #include	<error.h>
 #include	<ls.h>
+#define MEM_TAG	MEM_HIST
 #include	"defs.h"
 #include	"variables.h"
 #include	"path.h"
@@ -88,6 +94,23 @@
 #ifndef O_BINARY
 #   define O_BINARY	0
 #endif /* O_BINARY */
+#ifndef O_NOFOLLOW
+#   define O_NOFOLLOW	0
+#endif /* O_NOFOLLOW */
+
+#if _lib_mmap && _sys_mman
+#   include	<sys/mman.h>
+#else
+#   undef _lib_mmap
+#endif
+
+typedef struct
+{
+	off_t	here;		/* file offset of the next chunk */
+	off_t	last;		/* map up to here; 0 after the first chunk */
+	char	*addr;		/* mapped chunk */
+	size_t	len;
+} Histmap_t;
 
 int	_Hist = 0;
 static void	hist_marker(char*,long);
@@ -97,6 +120,11 @@ static int	hist_check(int);
 static int	hist_clean(int);
 static ssize_t	hist_write(Sfio_t*, const void*, size_t, Sfdisc_t*);
 static int	hist_exceptf(Sfio_t*, int, void*, Sfdisc_t*);
+static struct Histidx	*hidx_get(History_t*);
+static int	hidx_find(History_t*, char*, int, int, int, Histloc_t*, int*);
+static void	hidx_append(History_t*, off_t, char*, size_t, size_t);
+static void	hidx_rebuild(History_t*);
+static void	hidx_free(History_t*);
 
 static int	histinit;
 static mode_t	histmode;
@@ -282,6 +310,8 @@ retry:
 	hp->histcmds[1] = 2;
 	hp->histcnt = 2;
 	hp->histname = sh_strdup(histname);
+	hp->histidx = 0;
+	hp->histsync = 0;
 	hp->histdisc = hist_disc;
 	if(hsize==0)
 	{
@@ -371,6 +401,7 @@ retry:
 void hist_close(History_t *hp)
 {
 	sfclose(hp->histfp);
+	hidx_free(hp);
 #if SHOPT_AUDIT
 	if(hp->auditfp)
 	{
@@ -480,6 +511,8 @@ static History_t* hist_trim(History_t *hp, int n)
 		sfwrite(hist_new->histfp,buff,c);
 	}
 	hist_cancel(hist_new);
+	hidx_rebuild(hist_new);
+	hidx_free(hist_old);
 	sfclose(hist_old->histfp);
 	free(hist_old);
 	return hist_ptr = hist_new;
@@ -545,6 +578,46 @@ begin:
 	return 1;
 }
 
+/*
+ * return the next chunk of the history file for hist_eof() and set <size>
+ * if more than HIST_MAPMIN bytes are left up to <mp->last>, these are mapped
+ * into memory in one go rather than read through the 4K stream buffer
+ * the chunk ends just after a nonzero byte before the end of the mapping,
+ * as hist_eof() puts a 0 after the chunk and can't resume in a run of 0s
+ */
+static char *hist_chunk(History_t *hp, Histmap_t *mp, int *size)
+{
+	char *cp;
+#if _lib_mmap
+	off_t base, end = mp->last;
+	if(mp->addr)
+	{
+		munmap(mp->addr,mp->len);
+		mp->addr = 0;
+	}
+	else if(end-mp->here > HIST_MAPMIN)
+	{
+		if(end-mp->here > HIST_MAPMAX)
+			end = mp->here+HIST_MAPMAX;
+		base = mp->here - mp->here%sysconf(_SC_PAGESIZE);
+		mp->len = end-base;
+		if((cp = mmap(NULL,mp->len,PROT_READ|PROT_WRITE,MAP_PRIVATE,sffileno(hp->histfp),base)) != (char*)MAP_FAILED)
+		{
+			mp->addr = cp;
+			mp->last = 0;
+			cp += mp->here-base;
+			for(*size = end-1-mp->here; *size > 0 && cp[*size-1]==0; --*size);
+			sfseek(hp->histfp,mp->here+*size,SEEK_SET);
+			return cp;
+		}
+	}
+	mp->last = 0;
+#endif /* _lib_mmap */
+	if(cp = (char*)sfreserve(hp->histfp,SFIO_UNBOUND,0))
+		*size = sfvalue(hp->histfp);
+	return cp;
+}
+
 /*
  * This routine reads the history file from the present position
  * to the end-of-file and puts the information in the in-core
@@ -561,6 +634,9 @@ void hist_eof(History_t *hp)
 	off_t count = hp->histcnt;
 	int oldind=0,n,skip=0;
 	off_t last = sfseek(hp->histfp,0,SEEK_END);
+	Histmap_t map;
+	if(last == count)
+		return;
 	if(last < count)
 	{
 		last = -1;
@@ -571,9 +647,11 @@ void hist_eof(History_t *hp)
 	}
 again:
 	sfseek(hp->histfp,count,SEEK_SET);
-	while(cp=(char*)sfreserve(hp->histfp,SFIO_UNBOUND,0))
+	map.addr = 0;
+	map.here = count;
+	map.last = last;
+	while(cp=hist_chunk(hp,&map,&n))
 	{
-		n = sfvalue(hp->histfp);
 		*(endbuff = cp+n) = 0;
 		first = cp += skip;
 		while(1)
@@ -700,8 +778,14 @@ void hist_flush(History_t *hp)
 			hist_close(hp);
 			if(!sh_histinit())
 				sh_offoption(SH_HISTORY);
+			return;
 		}
 		hp->histflush = 0;
+		if(hp->histsync)
+		{
+			hp->histsync = 0;
+			hist_eof(hp);
+		}
 	}
 }
 
@@ -715,17 +799,13 @@ static ssize_t hist_write(Sfio_t *iop,const void *buff,size_t insize,Sfdisc_t* h
 	History_t *hp = (History_t*)handle;
 	char *bufptr = ((char*)buff)+insize;
 	int c,size = insize;
-	off_t cur;
+	int ind = hp->histind;
+	size_t len;
+	off_t cur, start = hp->histcnt, marker = hp->histmarker;
 	int saved=0;
 	char saveptr[HIST_MARKSZ];
 	if(!hp->histflush)
 		return write(sffileno(iop),(char*)buff,size);
-	if((cur = lseek(sffileno(iop),0,SEEK_END)) <0)
-	{
-		errormsg(SH_DICT,2,"hist_flush: EOF seek failed errno=%d",errno);
-		return -1;
-	}
-	hp->histcnt = cur;
 	/* remove whitespace from end of commands */
 	while(--bufptr >= (char*)buff)
 	{
@@ -743,6 +823,7 @@ static ssize_t hist_write(Sfio_t *iop,const void *buff,size_t insize,Sfdisc_t* h
 	*bufptr++ = '\n';
 	*bufptr++ = 0;
 	size = bufptr - (char*)buff;
+	len = size-1;
 #if	 SHOPT_AUDIT
 	if(hp->auditfp)
 	{
@@ -775,7 +856,12 @@ static ssize_t hist_write(Sfio_t *iop,const void *buff,size_t insize,Sfdisc_t* h
 	hp->histcnt +=  size;
 	c = hist_ind(hp,++hp->histind);
 	hp->histcmds[c] = hp->histcnt;
-	if(hp->histflush>HIST_MARKSZ && hp->histcnt > hp->histmarker+HIST_BSIZE/2)
+	/*
+	 * A marker holds the number of this command, which is only right if no
+	 * other shell appended since the last hist_eof(). If one did, the marker
+	 * waits for the next command, after hist_flush() has caught up.
+	 */
+	if(hp->histflush>HIST_MARKSZ && hp->histcnt > hp->histmarker+HIST_BSIZE/2 && lseek(sffileno(iop),0,SEEK_END)==start)
 	{
 		memcpy(saveptr,bufptr,HIST_MARKSZ);
 		saved=1;
@@ -784,6 +870,12 @@ static ssize_t hist_write(Sfio_t *iop,const void *buff,size_t insize,Sfdisc_t* h
 		hp->histmarker = hp->histcmds[hist_ind(hp,c)] = hp->histcnt;
 		size += HIST_MARKSZ;
 	}
+	/*
+	 * The command and any marker are appended with a single write(2), which
+	 * O_APPEND puts at the end of the file in one piece even if other shells
+	 * append at the same time, so no locking is needed. The file offset after
+	 * the write tells where the command went.
+	 */
 	errno = 0;
 	size = write(sffileno(iop),(char*)buff,size);
 	if(saved)
@@ -791,6 +883,15 @@ static ssize_t hist_write(Sfio_t *iop,const void *buff,size_t insize,Sfdisc_t* h
 	if(size>=0)
 	{
 		hp->histwfail = 0;
+		if((cur = lseek(sffileno(iop),0,SEEK_CUR)-size) != start)
+		{
+			/* other shells appended first, so let hist_flush() read it all in file order */
+			hp->histcnt = start;
+			hp->histind = ind;
+			hp->histmarker = marker;
+			hp->histsync = 1;
+		}
+		hidx_append(hp,cur,(char*)buff,len,size);
 		return insize;
 	}
 	return -1;
@@ -899,6 +1000,8 @@ Histloc_t hist_find(History_t*hp,char *string,int index1,int flag,int direction)
 	}
 	else if(index1 >= index2)
 		return location;
+	if(hidx_find(hp,string,index1,index2,direction,&location,coffset) >= 0)
+		return location;
 	while(index1!=index2)
 	{
 		direction>0?++index1:--index1;
@@ -951,6 +1054,755 @@ int hist_match(History_t *hp,off_t offset,char *string,int *coffset)
 }
 
 
+/*
+ * History search index
+ *
+ * Searching the history file command by command takes a seek and a read
+ * per command, which is slow for a large HISTSIZE and more so on a network
+ * file system. So the first search loads or builds an index of the history
+ * file: a table with the offset, size and number of lines of each command
+ * in file order, and for each hashed trigram a posting list holding the
+ * ordinals of the commands that contain it.
+ *
+ * Only the commands from the oldest one within reach of HISTSIZE onwards
+ * are indexed. The index is kept in the sidecar file <histname>.idx. This starts with a
+ * snapshot of the index (header, offset table and delta-encoded posting
+ * lists) followed by tail records, each appended with a single write(2) by
+ * hist_write() for the command it added. Shells sharing the history file
+ * append tail records concurrently, so these may be out of order, lost, or
+ * missing for commands written by older shells; the loader sorts them and
+ * scans the history file itself for the commands in between. Once enough
+ * tail records have piled up, the snapshot is rewritten to a temporary
+ * file that is renamed over the sidecar file.
+ *
+ * The index only narrows down the search: each candidate is checked with
+ * hist_tell() and hist_match(), so a stale index cannot produce a match.
+ */
+
+#define HIDX_BITS	13
+#define HIDX_NLIST	(1<<HIDX_BITS)	/* number of posting lists */
+#define HIDX_MAXLIST	32		/* max posting lists intersected per search */
+#define HIDX_MAXTRI	2048		/* max trigrams in a tail record */
+#define HIDX_TAILMAX	256		/* rewrite snapshot after this many new commands */
+#define HIDX_SUMSZ	16		/* history bytes checked against a snapshot */
+#define HIDX_LOCATE	16		/* hist_locate() counts without index up to this */
+#define HIDX_BSIZE	(64*1024)	/* history file read size */
+#define HIDX_MAGIC	"\0kshidx1"
+#define HIDX_ORDER	0x01020304
+#define HIDX_RECORD	0x68696478	/* tail record magic */
+
+typedef struct
+{
+	off_t		off;		/* offset of command in history file */
+	uint32_t	size;		/* bytes up to the next command */
+	uint32_t	lines;		/* number of newlines in command */
+} Hidxcmd_t;
+
+typedef struct
+{
+	uint32_t	*ord;		/* command ordinals in ascending order */
+	uint32_t	n;
+	uint32_t	max;
+} Hidxlist_t;
+
+struct Histidx
+{
+	char		*name;		/* sidecar file name */
+	int		fd;		/* sidecar file open for tail records, see hidx_append() */
+	ino_t		ino;		/* indexed history file */
+	off_t		start;		/* commands from this offset ... */
+	off_t		end;		/* ... up to this offset are indexed */
+	Hidxcmd_t	*cmd;		/* offset table in file order */
+	uint32_t	ncmd;
+	uint32_t	maxcmd;
+	uint32_t	nsnap;		/* commands in the sidecar snapshot */
+	Hidxlist_t	*list;		/* posting lists, NULL until loaded */
+};
+
+/* sidecar file header, followed by <ncmd> Hidxrec_t and <nblob> bytes of posting lists */
+typedef struct
+{
+	char		magic[8];
+	uint32_t	order;
+	uint32_t	nlist;
+	uint64_t	ino;
+	int64_t		start;
+	int64_t		end;
+	uint64_t	nblob;
+	uint32_t	ncmd;
+	uint32_t	sum;
+} Hidxhead_t;
+
+typedef struct
+{
+	int64_t		off;
+	uint32_t	size;
+	uint32_t	lines;
+} Hidxrec_t;
+
+/* sidecar file tail record, followed by <ntri> uint16_t posting list numbers */
+typedef struct
+{
+	uint32_t	magic;
+	uint32_t	ntri;
+	uint64_t	ino;
+	int64_t		off;
+	uint32_t	size;
+	uint32_t	lines;
+} Hidxtail_t;
+
+typedef struct
+{
+	Hidxtail_t	t;
+	unsigned char	*tri;
+} Hidxpend_t;
+
+static uint32_t hidx_hash(const unsigned char *cp)
+{
+	return ((uint32_t)cp[0]<<16|(uint32_t)cp[1]<<8|cp[2])*0x9e3779b1U >> (32-HIDX_BITS);
+}
+
+/*
+ * checksum of the history bytes before <end>, so that a snapshot
+ * is not used for another file that happens to reuse the inode
+ */
+static uint32_t hidx_sum(int fd, off_t end)
+{
+	unsigned char	buff[HIDX_SUMSZ];
+	uint32_t	sum = 2166136261U;
+	off_t		start = end > HIDX_SUMSZ+2 ? end-HIDX_SUMSZ : 2;
+	ssize_t		i, n = 0;
+	if(end > start && (n = pread(fd,buff,end-start,start)) < 0)
+		n = 0;
+	for(i=0; i < n; i++)
+		sum = (sum^buff[i])*16777619U;
+	return sum;
+}
+
+static void hidx_post(Hidxlist_t *lp, uint32_t ord)
+{
+	if(lp->n && lp->ord[lp->n-1]==ord)
+		return;
+	if(lp->n==lp->max)
+		lp->ord = sh_realloc(lp->ord,(lp->max = lp->max ? 2*lp->max : 4)*sizeof(uint32_t));
+	lp->ord[lp->n++] = ord;
+}
+
+/*
+ * add a command to the offset table and return its ordinal
+ */
+static uint32_t hidx_cmd(struct Histidx *hx, off_t off, size_t size, size_t lines)
+{
+	Hidxcmd_t *cp;
+	if(hx->ncmd==hx->maxcmd)
+		hx->cmd = sh_realloc(hx->cmd,(hx->maxcmd = hx->maxcmd ? 2*hx->maxcmd : 256)*sizeof(Hidxcmd_t));
+	cp = &hx->cmd[hx->ncmd];
+	cp->off = off;
+	cp->size = size;
+	cp->lines = lines;
+	hx->end = off+size;
+	return hx->ncmd++;
+}
+
+/*
+ * add command <cp> of <len> bytes at offset <off> to the index
+ */
+static void hidx_add(struct Histidx *hx, off_t off, const unsigned char *cp, size_t len, size_t size)
+{
+	const unsigned char	*sp, *ep = cp+len;
+	size_t			lines = 0;
+	uint32_t		ord;
+	for(sp=cp; sp < ep && (sp = memchr(sp,'\n',ep-sp)); sp++)
+		lines++;
+	ord = hidx_cmd(hx,off,size,lines);
+	for(; cp+2 < ep; cp++)
+		hidx_post(&hx->list[hidx_hash(cp)],ord);
+}
+
+/*
+ * return ordinal of the command at <off>, or -1 if it is not indexed
+ */
+static long hidx_ord(struct Histidx *hx, off_t off)
+{
+	uint32_t lo=0, hi=hx->ncmd, mid;
+	while(lo < hi)
+	{
+		mid = lo+(hi-lo)/2;
+		if(hx->cmd[mid].off < off)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	return lo<hx->ncmd && hx->cmd[lo].off==off ? (long)lo : -1;
+}
+
+static int hidx_has(Hidxlist_t *lp, uint32_t ord)
+{
+	uint32_t lo=0, hi=lp->n, mid;
+	while(lo < hi)
+	{
+		mid = lo+(hi-lo)/2;
+		if(lp->ord[mid] < ord)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	return lo<lp->n && lp->ord[lo]==ord;
+}
+
+/*
+ * index the commands in the history file from hx->end up to <end>,
+ * stopping at a command that has not been completely written yet
+ */
+static void hidx_scan(History_t *hp, off_t end)
+{
+	struct Histidx	*hx = hp->histidx;
+	size_t		bsize = HIDX_BSIZE, have = 0;
+	unsigned char	*buff = sh_malloc(bsize), *cp, *sp, *ep;
+	off_t		pos = hx->end;
+	ssize_t		n;
+	while(pos+(off_t)have < end)
+	{
+		if(have==bsize)
+			buff = sh_realloc(buff,bsize*=2);
+		n = bsize-have;
+		if(n > end-pos-(off_t)have)
+			n = end-pos-have;
+		if((n = pread(sffileno(hp->histfp),buff+have,n,pos+have)) <= 0)
+			break;
+		have += n;
+		for(cp=buff,ep=buff+have; cp < ep; cp=sp)
+		{
+			sp = cp+1;
+			if(*cp==0)
+				continue;
+			if(*cp==HIST_CMDNO || *cp==HIST_UNDO)
+			{
+				if(sp >= ep)
+					break;
+				if(*sp==0)
+				{
+					sp = cp + (*cp==HIST_CMDNO ? HIST_MARKSZ : 2);
+					if(sp > ep)
+						break;
+					continue;
+				}
+			}
+			if(!(sp = memchr(cp,0,ep-cp)))
+				break;
+			sp++;
+			hidx_add(hx,pos+(cp-buff),cp,sp-1-cp,sp-cp);
+		}
+		n = cp-buff;
+		pos += n;
+		have -= n;
+		memmove(buff,cp,have);
+	}
+	hx->end = pos;
+	free(buff);
+}
+
+static struct Histidx *hidx_open(History_t *hp)
+{
+	struct Histidx	*hx;
+	struct stat	statb;
+	if(!(hx = hp->histidx))
+	{
+		if(fstat(sffileno(hp->histfp),&statb) < 0)
+			return NULL;
+		hx = hp->histidx = sh_newof(0,struct Histidx,1,strlen(hp->histname)+5);
+		hx->name = (char*)(hx+1);
+		strcopy(strcopy(hx->name,hp->histname),".idx");
+		hx->fd = -1;
+		hx->ino = statb.st_ino;
+		hx->start = hx->end = 2;
+	}
+	return hx;
+}
+
+static void hidx_close(struct Histidx *hx)
+{
+	if(hx->fd >= 0)
+		close(hx->fd);
+	hx->fd = -1;
+}
+
+/*
+ * empty the index but keep the posting list table
+ */
+static void hidx_clear(struct Histidx *hx)
+{
+	Hidxlist_t *lp;
+	for(lp=hx->list; lp < hx->list+HIDX_NLIST; lp++)
+		free(lp->ord);
+	memset(hx->list,0,HIDX_NLIST*sizeof(Hidxlist_t));
+	free(hx->cmd);
+	hx->cmd = 0;
+	hx->ncmd = hx->maxcmd = hx->nsnap = 0;
+	hx->end = hx->start;
+}
+
+static void hidx_reset(struct Histidx *hx)
+{
+	if(hx->list)
+	{
+		hidx_clear(hx);
+		free(hx->list);
+		hx->list = 0;
+	}
+}
+
+static void hidx_free(History_t *hp)
+{
+	if(hp->histidx)
+	{
+		hidx_reset(hp->histidx);
+		hidx_close(hp->histidx);
+		free(hp->histidx);
+		hp->histidx = 0;
+	}
+}
+
+/*
+ * write the index to a new sidecar file
+ */
+static void hidx_save(History_t *hp)
+{
+	struct Histidx	*hx = hp->histidx;
+	Hidxhead_t	head;
+	Hidxrec_t	rec;
+	Hidxlist_t	*lp;
+	struct stat	statb;
+	Sfio_t		*out, *blob;
+	char		*tmp;
+	uint32_t	i;
+	int		fd, err;
+	/* don't write an index next to a history file that is not the one in use */
+	if(stat(hp->histname,&statb) < 0 || statb.st_ino!=hx->ino || !(blob = sfstropen()))
+		return;
+	/* number of lists, then for each nonempty list its number, length and ordinal deltas */
+	for(i=0, lp=hx->list; lp < hx->list+HIDX_NLIST; lp++)
+		i += lp->n>0;
+	sfputu(blob,i);
+	for(lp=hx->list; lp < hx->list+HIDX_NLIST; lp++)
+	{
+		if(lp->n==0)
+			continue;
+		sfputu(blob,lp-hx->list);
+		sfputu(blob,lp->n);
+		for(i=0; i < lp->n; i++)
+			sfputu(blob,lp->ord[i]-(i ? lp->ord[i-1] : 0));
+	}
+	memset(&head,0,sizeof(head));
+	memcpy(head.magic,HIDX_MAGIC,sizeof(head.magic));
+	head.order = HIDX_ORDER;
+	head.nlist = HIDX_NLIST;
+	head.ino = hx->ino;
+	head.start = hx->start;
+	head.end = hx->end;
+	head.nblob = sfstrtell(blob);
+	head.ncmd = hx->ncmd;
+	head.sum = hidx_sum(sffileno(hp->histfp),hx->end);
+	tmp = sh_malloc(strlen(hx->name)+24);
+	sfsprintf(tmp,strlen(hx->name)+24,"%s.%jd",hx->name,(Sflong_t)sh.current_pid);
+	/* never write through a file or symlink that someone else put there; one left by a dead shell is removed */
+	if((fd = open(tmp,O_BINARY|O_WRONLY|O_CREAT|O_EXCL|O_NOFOLLOW|O_cloexec,histmode)) < 0 && errno==EEXIST && unlink(tmp) >= 0)
+		fd = open(tmp,O_BINARY|O_WRONLY|O_CREAT|O_EXCL|O_NOFOLLOW|O_cloexec,histmode);
+	if(fd >= 0)
+	{
+		if(out = sfnew(NULL,NULL,SFIO_UNBOUND,fd,SFIO_WRITE))
+		{
+			sfwrite(out,&head,sizeof(head));
+			for(i=0; i < hx->ncmd; i++)
+			{
+				rec.off = hx->cmd[i].off;
+				rec.size = hx->cmd[i].size;
+				rec.lines = hx->cmd[i].lines;
+				sfwrite(out,&rec,sizeof(rec));
+			}
+			sfwrite(out,sfstrbase(blob),head.nblob);
+			err = sferror(out);
+			if(sfclose(out) >= 0 && !err && rename(tmp,hx->name) >= 0)
+			{
+				hx->nsnap = hx->ncmd;
+				hidx_close(hx);		/* append to the new sidecar file */
+			}
+		}
+		else
+			close(fd);
+		if(hx->nsnap!=hx->ncmd)
+			unlink(tmp);
+	}
+	free(tmp);
+	sfstrclose(blob);
+}
+
+/*
+ * read the snapshot in sidecar file <fd> for history file <hst>
+ * returns the sidecar file offset of the tail records or -1
+ */
+static off_t hidx_read(History_t *hp, int fd, struct stat *hst)
+{
+	struct Histidx	*hx = hp->histidx;
+	Hidxhead_t	head;
+	Hidxrec_t	*rec = 0;
+	Hidxlist_t	*lp;
+	Sfio_t		*blob = 0;
+	char		*buff = 0;
+	Sfulong_t	n, d, ord;
+	uint32_t	i;
+	off_t		r = -1;
+	if(read(fd,&head,sizeof(head))!=sizeof(head) || memcmp(head.magic,HIDX_MAGIC,sizeof(head.magic))
+	|| head.order!=HIDX_ORDER || head.nlist!=HIDX_NLIST || head.ino!=hst->st_ino
+	|| head.start < 2 || head.start > hx->start || head.end < head.start || head.end > hst->st_size
+	|| head.ncmd > head.end/2 || head.nblob > (uint64_t)head.end*8)
+		return -1;
+	if(head.sum!=hidx_sum(sffileno(hp->histfp),head.end))
+		return -1;
+	rec = sh_malloc(head.ncmd*sizeof(Hidxrec_t)+1);
+	buff = sh_malloc(head.nblob+1);
+	if(read(fd,rec,head.ncmd*sizeof(Hidxrec_t))!=(ssize_t)(head.ncmd*sizeof(Hidxrec_t)) || read(fd,buff,head.nblob)!=(ssize_t)head.nblob)
+		goto done;
+	for(hx->end=head.start, i=0; i < head.ncmd; i++)
+	{
+		if(rec[i].off < hx->end || rec[i].size==0 || rec[i].off+rec[i].size > head.end)
+			goto done;
+		hidx_cmd(hx,rec[i].off,rec[i].size,rec[i].lines);
+	}
+	if(!(blob = sfnew(NULL,buff,head.nblob,-1,SFIO_STRING|SFIO_READ)))
+		goto done;
+	for(i=sfgetu(blob); i-- > 0;)
+	{
+		if((n = sfgetu(blob)) >= HIDX_NLIST || (lp = &hx->list[n])->n)
+			goto done;
+		if((n = sfgetu(blob))==0 || n > head.ncmd)
+			goto done;
+		lp->ord = sh_malloc((lp->max = n)*sizeof(uint32_t));
+		for(ord=0; lp->n < n; lp->ord[lp->n++] = ord)
+		{
+			if((d = sfgetu(blob)) >= head.ncmd || (lp->n && d==0) || (ord += d) >= head.ncmd)
+				goto done;
+		}
+	}
+	if(sferror(blob))
+		goto done;
+	hx->start = head.start;
+	hx->end = head.end;
+	hx->nsnap = head.ncmd;
+	r = sizeof(head)+head.ncmd*sizeof(Hidxrec_t)+head.nblob;
+done:
+	if(blob)
+		sfclose(blob);
+	free(buff);
+	free(rec);
+	if(r < 0)
+		hidx_clear(hx);
+	return r;
+}
+
+static int hidx_cmpoff(const void *a, const void *b)
+{
+	int64_t x = ((Hidxpend_t*)a)->t.off, y = ((Hidxpend_t*)b)->t.off;
+	return x<y ? -1 : x>y;
+}
+
+static int hidx_cmptri(const void *a, const void *b)
+{
+	return (int)*(uint16_t*)a - (int)*(uint16_t*)b;
+}
+
+/*
+ * load the index from the sidecar file and the history file <hst>
+ */
+static void hidx_load(History_t *hp, struct stat *hst)
+{
+	struct Histidx	*hx = hp->histidx;
+	Hidxpend_t	*pend = 0, *pp;
+	unsigned char	*buff = 0, *cp, *ep;
+	struct stat	statb;
+	size_t		npend = 0, j;
+	ssize_t		n;
+	uint32_t	ord;
+	uint16_t	tri;
+	off_t		off;
+	int		fd, first = hp->histind-hp->histsize;
+	hx->ino = hst->st_ino;
+	hx->list = sh_newof(0,Hidxlist_t,HIDX_NLIST,0);
+	if((hx->start = hist_tell(hp,first > 1 ? first : 1)) < 2)
+		hx->start = 2;
+	hx->end = hx->start;
+	if((fd = open(hx->name,O_BINARY|O_RDONLY|O_cloexec)) >= 0)
+	{
+		if((off = hidx_read(hp,fd,hst)) >= 0 && fstat(fd,&statb) >= 0 && statb.st_size > off)
+		{
+			buff = sh_malloc(statb.st_size-off);
+			if((n = read(fd,buff,statb.st_size-off)) < 0)
+				n = 0;
+			pend = sh_malloc((n/sizeof(Hidxtail_t)+1)*sizeof(Hidxpend_t));
+			for(cp=buff, ep=buff+n; cp+sizeof(Hidxtail_t) <= ep; cp += sizeof(Hidxtail_t)+pp->t.ntri*sizeof(uint16_t))
+			{
+				pp = &pend[npend];
+				memcpy(&pp->t,cp,sizeof(Hidxtail_t));
+				if(pp->t.magic!=HIDX_RECORD || pp->t.ntri > HIDX_MAXTRI || (size_t)(ep-cp) < sizeof(Hidxtail_t)+pp->t.ntri*sizeof(uint16_t))
+					break;
+				pp->tri = cp+sizeof(Hidxtail_t);
+				if(pp->t.ino==hx->ino && pp->t.off >= hx->end && pp->t.size > 0 && pp->t.off+pp->t.size <= hst->st_size)
+					npend++;
+			}
+		}
+		close(fd);
+	}
+	/* records of concurrent shells may be out of order; fill any gaps from the history file */
+	if(npend)
+		qsort(pend,npend,sizeof(Hidxpend_t),hidx_cmpoff);
+	for(pp=pend; pp < pend+npend; pp++)
+	{
+		if(pp->t.off > hx->end)
+			hidx_scan(hp,pp->t.off);
+		if(pp->t.off!=hx->end)
+			continue;
+		ord = hidx_cmd(hx,pp->t.off,pp->t.size,pp->t.lines);
+		for(j=0; j < pp->t.ntri; j++)
+		{
+			memcpy(&tri,pp->tri+j*sizeof(uint16_t),sizeof(uint16_t));
+			if(tri < HIDX_NLIST)
+				hidx_post(&hx->list[tri],ord);
+		}
+	}
+	free(pend);
+	free(buff);
+	hidx_scan(hp,hst->st_size);
+	if(hx->ncmd-hx->nsnap > HIDX_TAILMAX || (hx->ncmd && !hx->nsnap))
+		hidx_save(hp);
+}
+
+/*
+ * return the search index for the history file, updated with the
+ * commands that were added to the history file since the last call
+ */
+static struct Histidx *hidx_get(History_t *hp)
+{
+	struct Histidx	*hx;
+	struct stat	statb;
+	if(!(hx = hidx_open(hp)) || fstat(sffileno(hp->histfp),&statb) < 0)
+		return NULL;
+	/* another shell may have replaced the sidecar file; reopen it for the next tail record */
+	hidx_close(hx);
+	/* the history file was replaced or truncated */
+	if(hx->list && (statb.st_ino!=hx->ino || statb.st_size < hx->end))
+		hidx_reset(hx);
+	if(!hx->list)
+		hidx_load(hp,&statb);
+	else if(statb.st_size > hx->end)
+		hidx_scan(hp,statb.st_size);
+	return hx;
+}
+
+/*
+ * rebuild the sidecar file, if there is one, for a history file written by hist_trim()
+ */
+static void hidx_rebuild(History_t *hp)
+{
+	struct Histidx *hx;
+	if((hx = hidx_open(hp)) && access(hx->name,F_OK)==0 && hidx_get(hp))
+		hidx_reset(hx);
+}
+
+/*
+ * add the command of <len> bytes that hist_write() wrote at <off> to the index
+ * and append a tail record for it to the sidecar file
+ */
+static void hidx_append(History_t *hp, off_t off, char *cmd, size_t len, size_t size)
+{
+	struct Histidx	*hx;
+	unsigned char	*cp = (unsigned char*)cmd;
+	char		buff[sizeof(Hidxtail_t)+HIDX_MAXTRI*sizeof(uint16_t)];
+	Hidxtail_t	rec;
+	uint16_t	tri[HIDX_MAXTRI];
+	size_t		i, n = 0;
+	if(off < 2 || !(hx = hidx_open(hp)))
+		return;
+	if(hx->list && hx->end==off)
+		hidx_add(hx,off,cp,len,size);
+	if(len > HIDX_MAXTRI+2)
+		return;
+	/* the sidecar file stays open between commands; -2 means there was none at the last try */
+	if(hx->fd==-1 && (hx->fd = open(hx->name,O_BINARY|O_WRONLY|O_APPEND|O_cloexec)) < 0)
+		hx->fd = -2;
+	if(hx->fd < 0)
+		return;
+	for(i=0; i+2 < len; i++)
+		tri[i] = hidx_hash(cp+i);
+	if(n = i)
+	{
+		qsort(tri,n,sizeof(uint16_t),hidx_cmptri);
+		for(n=i=1; i+2 < len; i++)
+			if(tri[i]!=tri[n-1])
+				tri[n++] = tri[i];
+	}
+	memset(&rec,0,sizeof(rec));
+	rec.magic = HIDX_RECORD;
+	rec.ntri = n;
+	rec.ino = hx->ino;
+	rec.off = off;
+	rec.size = size;
+	for(i=0; i < len; i++)
+		if(cp[i]=='\n')
+			rec.lines++;
+	memcpy(buff,&rec,sizeof(rec));
+	memcpy(buff+sizeof(rec),tri,n*sizeof(uint16_t));
+	write(hx->fd,buff,sizeof(rec)+n*sizeof(uint16_t));
+}
+
+/*
+ * return the number of the first command from <lo> up to <hi> at or after offset <off>, or hi+1
+ */
+static int hidx_lower(History_t *hp, off_t off, int lo, int hi)
+{
+	int mid;
+	for(hi++; lo < hi;)
+	{
+		mid = lo+(hi-lo)/2;
+		if(hist_tell(hp,mid) < off)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * return the number of the command at offset <off> between <lo> and <hi> or -1
+ */
+static int hidx_cmdno(History_t *hp, off_t off, int lo, int hi)
+{
+	lo = hidx_lower(hp,off,lo,hi);
+	return lo<=hi && hist_tell(hp,lo)==off ? lo : -1;
+}
+
+/*
+ * search commands <lo> to <hi> one by one in <direction> like hist_find()
+ * returns 1 if the search is over
+ */
+static int hidx_tail(History_t *hp, char *string, int lo, int hi, int direction, Histloc_t *location, int *coffset)
+{
+	int n = direction<0 ? hi : lo;
+	for(; n >= lo && n <= hi; n += direction<0 ? -1 : 1)
+	{
+		if((location->hist_line = hist_match(hp,hist_tell(hp,n),string,coffset)) >= 0)
+		{
+			location->hist_command = n;
+			return 1;
+		}
+		/* allow a search to be aborted */
+		if(sh.trapnote & SH_SIGSET)
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * search the commands after <index1> up to <index2> in <direction> for
+ * <string> like hist_find(), skipping the commands that the index rules out
+ * commands after the end of the index, which hidx_scan() left for a command
+ * that was not completely written yet, are searched one by one
+ * returns -1 if the index can't be used for this search
+ */
+static int hidx_find(History_t *hp, char *string, int index1, int index2, int direction, Histloc_t *location, int *coffset)
+{
+	struct Histidx	*hx;
+	Hidxlist_t	*lp, *list[HIDX_MAXLIST];
+	unsigned char	*cp = (unsigned char*)string;
+	size_t		len = strlen(string);
+	uint32_t	lo, hi, mid, ord;
+	off_t		off, first, last;
+	int		i, n, tail, nlist = 0;
+	if(len < 3 || !(hx = hidx_get(hp)))
+		return -1;
+	if(direction<0)
+	{
+		first = hist_tell(hp,index2);
+		last = hist_tell(hp,--index1);
+	}
+	else
+	{
+		first = hist_tell(hp,++index1);
+		last = hist_tell(hp,index2);
+	}
+	if(first < hx->start)
+		return -1;
+	/* from here on, index1 is the lowest and index2 the highest command to search */
+	if(direction<0)
+	{
+		n = index1;
+		index1 = index2;
+		index2 = n;
+	}
+	tail = last < hx->end ? index2+1 : hidx_lower(hp,hx->end,index1,index2);
+	/* the newest commands come first when searching backward */
+	if(direction<0 && hidx_tail(hp,string,tail,index2,direction,location,coffset))
+		return 0;
+	for(; cp+2 < (unsigned char*)string+len && nlist < HIDX_MAXLIST; cp++)
+	{
+		lp = &hx->list[hidx_hash(cp)];
+		if(lp->n==0)
+		{
+			nlist = 0;
+			break;
+		}
+		for(i=0; i < nlist && list[i]!=lp; i++);
+		if(i < nlist)
+			continue;
+		/* walk the shortest list and look up the commands in the others */
+		list[nlist++] = lp;
+		if(lp->n < list[0]->n)
+		{
+			list[nlist-1] = list[0];
+			list[0] = lp;
+		}
+	}
+	lp = nlist ? list[0] : 0;
+	for(lo=0, hi=lp ? lp->n : 0; lo < hi;)
+	{
+		mid = lo+(hi-lo)/2;
+		if(direction<0 ? hx->cmd[lp->ord[mid]].off <= last : hx->cmd[lp->ord[mid]].off < first)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	/* postings are in file order, so the nearest command is found first */
+	while(lp && (direction<0 ? lo-- > 0 : lo < lp->n))
+	{
+		ord = lp->ord[direction<0 ? lo : lo++];
+		if((off = hx->cmd[ord].off) < first || off > last)
+			break;
+		for(i=1; i < nlist && hidx_has(list[i],ord); i++);
+		if(i==nlist && (n = hidx_cmdno(hp,off,index1,index2)) >= 0
+		&& (location->hist_line = hist_match(hp,off,string,coffset)) >= 0)
+		{
+			location->hist_command = n;
+			return 0;
+		}
+		/* allow a search to be aborted */
+		if(sh.trapnote & SH_SIGSET)
+			return 0;
+	}
+	if(direction>0)
+		hidx_tail(hp,string,tail,index2,direction,location,coffset);
+	return 0;
+}
+
+#if SHOPT_ESH
+/*
+ * return the number of lines of the command at offset <off> or -1
+ */
+static int hidx_lines(struct Histidx *hx, off_t off)
+{
+	long ord = hidx_ord(hx,off);
+	return ord < 0 ? -1 : (int)hx->cmd[ord].lines;
+}
+#endif /* SHOPT_ESH */
+
 #if SHOPT_ESH || SHOPT_VSH
 /*
  * copy command <command> from history file to s1
@@ -1058,18 +1910,25 @@ char *hist_word(char *string,int size,int word)
 Histloc_t hist_locate(History_t *hp,int command,int line,int lines)
 {
 	Histloc_t next;
+	struct Histidx *hx;
 	line += lines;
 	if(!hp)
 	{
 		command = -1;
 		goto done;
 	}
+	/* counting the lines of a few commands is cheaper than loading the index */
+	if(lines > HIDX_LOCATE || lines < -HIDX_LOCATE || (hp->histidx && hp->histidx->list))
+		hx = hidx_get(hp);
+	else
+		hx = 0;
 	if(lines > 0)
 	{
 		int count;
 		while(command <= hp->histind)
 		{
-			count = hist_copy(NULL,0, command,-1);
+			if(!hx || (count = hidx_lines(hx,hist_tell(hp,command))) < 0)
+				count = hist_copy(NULL,0, command,-1);
 			if(count > line)
 				goto done;
 			line -= count;
@@ -1078,14 +1937,16 @@ Histloc_t hist_locate(History_t *hp,int command,int line,int lines)
 	}
 	else
 	{
-		int least = (int)hp->histind-hp->histsize;
+		int count, least = (int)hp->histind-hp->histsize;
 		while(1)
 		{
 			if(line >=0)
 				goto done;
 			if(--command < least)
 				break;
-			line += hist_copy(NULL,0, command,-1);
+			if(!hx || (count = hidx_lines(hx,hist_tell(hp,command))) < 0)
+				count = hist_copy(NULL,0, command,-1);
+			line += count;
 		}
 		command = -1;
 	}
@@ -1695,6 +1695,8 @@ static void refresh(Vi_t* vp, int mode)
 	int new_lw;
 	int ncur_phys;
 	int opflag;			/* search optimize flag */
+	int w_end;			/* last window cell that changed */
+	int long_char;
 
 	/*** find out if it's necessary to start translating at beginning ***/
 
@@ -1777,20 +1779,63 @@ static void refresh(Vi_t* vp, int mode)
 		return;
 	}
 
-	/*** copy the physical image to the window image ***/
+	if( last_phys >= w_size )
+	{
+		if( first_w == 0 )
+			long_char = '>';
+		else if( last_phys < (first_w+w_size) )
+			long_char = '<';
+		else
+			long_char = '*';
+	}
+	else
+		long_char = ' ';
 
+	/*** try to shift the rest of the line on the terminal ***/
+
+	if( first_w==0 && vp->ofirst_wind==0 && long_char==' ' && vp->long_line==' '
+		&& last_virt!=INVALID && last_phys<w_size-1 && vp->last_wind<w_size-1
+		&& window[0] && (w_end=ed_shift(vp->ed,window,cur_phys,vp->last_wind+1,physical,last_phys+1,first_w))>=0 )
+	{
+		cur_phys = w_end;
+		vp->last_wind = last_phys;
+		goto done;
+	}
+
+	/*** copy the physical image to the window image, ***/
+	/*** noting the last cell that changed unless the ***/
+	/*** window was cleared to force a total refresh ***/
+
+	if( window[0] && vp->ofirst_wind!=INVALID )
+		w_end = w - 1;
+	else
+		w_end = vp->last_wind;
 	if( last_virt != INVALID )
 	{
 		while( p <= last_phys && w < w_size )
+		{
+			if( w > w_end && (w > vp->last_wind || window[w] != physical[p]) )
+				w_end = w;
 			window[w++] = physical[p++];
+		}
 	}
 	new_lw = w;
 
 	/*** erase trailing characters if needed ***/
 
 	while( w <= vp->last_wind )
+	{
+		if( w > w_end && window[w] != ' ' )
+			w_end = w;
 		window[w++] = ' ';
+	}
 	vp->last_wind = --w;
+	if( vp->long_line != long_char )
+		w_end = vp->last_wind;
+#if SHOPT_MULTIBYTE
+	while( w_end < vp->last_wind && window[w_end+1]==MARKER )
+		w_end++;
+#endif /* SHOPT_MULTIBYTE */
 
 	p = p_differ;
 
@@ -1798,26 +1843,15 @@ static void refresh(Vi_t* vp, int mode)
 
 	cursor(vp,p);
 
-	/*** and output difference ***/
+	/*** and output difference up to the last changed cell ***/
 
 	w = p - first_w;
-	while( w <= vp->last_wind )
+	while( w <= w_end )
 		putchar(window[w++]);
 
 	cur_phys = w + first_w;
 	vp->last_wind = --new_lw;
-
-	if( last_phys >= w_size )
-	{
-		if( first_w == 0 )
-			vp->long_char = '>';
-		else if( last_phys < (first_w+w_size) )
-			vp->long_char = '<';
-		else
-			vp->long_char = '*';
-	}
-	else
-		vp->long_char = ' ';
+	vp->long_char = long_char;
 
 	if( vp->long_line != vp->long_char )
 	{
@@ -1834,6 +1868,7 @@ static void refresh(Vi_t* vp, int mode)
 
 	if(vp->ed->e_multiline && vp->ofirst_wind==INVALID)
 		ed_setcursor(vp->ed, physical, last_phys+1, last_phys+1, -1);
+done:
 	vp->ocur_phys = ncur_phys;
 	vp->ocur_virt = cur_virt;
 	vp->ofirst_wind = first_w;
@@ -0,0 +1,156 @@
+########################################################################
+#                                                                      #
+#               This software is part of the ast package               #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+: generate perfect hash indexes for static Shtable_t lookup tables
+
+# @(#)hashtab.sh (ksh 93u+m) 2026-10-19
+#
+# Each operand is a C source file in data/ that defines one table of the form
+#	const Shtable_t shtab_NAME[] =
+#	{
+#		"word",		VALUE,
+#		...
+#		"",		0
+#	};
+# where entries may be enclosed in '#if ... #endif'. For each table, this
+# finds a seed for which the hash function below maps every name to its own
+# slot and generates shtab_NAME_seed, shtab_NAME_mask and shtab_NAME_index[],
+# which gives the table position plus one of the name that hashes to a slot.
+# The hash must match sh_hashlocate() in sh/string.c:
+#	h = seed; for each byte c: h = (h * 33 + c) % 65521; slot = h & mask
+
+case $ZSH_VERSION in
+?*)	emulate ksh ;;
+*)	(command set -o posix) 2>/dev/null && set -o posix ;;
+esac
+set -o noglob
+
+command=$0
+eval $1
+shift
+
+ncond=0
+for file
+do	echo "/* : : generated by $command from ${file#"${PACKAGEROOT:-/dev/null}"[\\/]} : : */"
+	exec < $file
+	table=
+	count=0		# number of entries
+	base=0		# number of unconditional entries so far
+	conds=		# sum of the conditions of the conditional entries so far
+	cond=		# condition of the current #if block
+	while	IFS= read -r line
+	do	case $table in
+		'')	case $line in
+			'const Shtable_t shtab_'*'[]'*)
+				table=${line#const Shtable_t }
+				table=${table%%\[*}
+				;;
+			esac
+			continue
+			;;
+		esac
+		case $line in
+		'#if '*)
+			ncond=$((ncond + 1))
+			cond=_hashtab_cond_$ncond
+			echo "${line%%[ 	]/\**}
+#define $cond	1
+#else
+#define $cond	0
+#endif"
+			;;
+		'#endif'*)
+			cond=
+			;;
+		'#'*)	echo "$command: $file: $line: not supported" >&2
+			exit 1
+			;;
+		*'"",'*|'};'*)
+			break
+			;;
+		*\"*)	name=${line#*\"}
+			name=${name%%\"*}
+			count=$((count + 1))
+			case $cond in
+			'')	base=$((base + 1))
+				eval "value_$count=\"$base\$conds\""
+				;;
+			*)	eval "value_$count=\"$cond?$((base + 1))\$conds:0\""
+				conds="$conds+$cond"
+				;;
+			esac
+			codes=
+			rest=$name
+			while	test -n "$rest"
+			do	c=${rest%"${rest#?}"}
+				rest=${rest#?}
+				codes="$codes $(printf %d "'$c")"
+			done
+			eval "name_$count=\$name codes_$count=\$codes"
+			;;
+		esac
+	done
+	case $table in
+	'')	echo "$command: $file: no Shtable_t table found" >&2
+		exit 1
+		;;
+	esac
+	size=1
+	while	test "$size" -lt "$((count * 2))"
+	do	size=$((size * 2))
+	done
+	mask=$((size - 1))
+	seed=0
+	while	:
+	do	seed=$((seed + 1))
+		if	test "$seed" -gt 100000
+		then	echo "$command: $table: no perfect hash found" >&2
+			exit 1
+		fi
+		used=' '
+		i=0
+		while	test "$i" -lt "$count"
+		do	i=$((i + 1))
+			eval "codes=\$codes_$i"
+			h=$seed
+			for c in $codes
+			do	h=$(((h * 33 + c) % 65521))
+			done
+			slot=$((h & mask))
+			case $used in
+			*" $slot "*)
+				continue 2 ;;
+			esac
+			used="$used$slot "
+			eval "slot_$slot=$i"
+		done
+		break
+	done
+	echo
+	echo "#define ${table}_seed	$seed"
+	echo "#define ${table}_mask	$mask"
+	echo "static const unsigned char ${table}_index[$size] ="
+	echo "{"
+	slot=0
+	while	test "$slot" -lt "$size"
+	do	case $used in
+		*" $slot "*)
+			eval "i=\$slot_$slot"
+			eval "echo \"	\$value_$i,	/* \$name_$i */\""
+			;;
+		*)	echo "	0,"
+			;;
+		esac
+		slot=$((slot + 1))
+	done
+	echo "};"
+done
@@ -71,7 +71,7 @@ struct slnod 	/* struct for linked list of stacks */
 struct dolnod
 {
 	int		dolrefcnt;	/* reference count */
-	int		dolmax;		/* size of dolval array */
+	int		dolmax;		/* DOLPOOL if block may be recycled */
 	int		dolnum;		/* number of elements */
 	int		dolbot;		/* current first element */
 	struct dolnod	*dolnxt;	/* used when lists are chained */
@@ -93,6 +93,7 @@ extern int b_eloop(int, char*[],Shbltin_t*);
 #endif /* SHOPT_MKSERVICE */
 extern int b_hist(int, char*[],Shbltin_t*);
 extern int b_let(int, char*[],Shbltin_t*);
+extern int b_parmap(int, char*[],Shbltin_t*);
 extern int b_read(int, char*[],Shbltin_t*);
 extern int b_ulimit(int, char*[],Shbltin_t*);
 extern int b_umask(int, char*[],Shbltin_t*);
@@ -109,6 +110,7 @@ extern int b_pwd(int, char*[],Shbltin_t*);
 extern int b_sleep(int, char*[],Shbltin_t*);
 extern int b_test(int, char*[],Shbltin_t*);
 extern int b_times(int, char*[],Shbltin_t*);
+extern int b_tracebuf(int, char*[],Shbltin_t*);
 #if !SHOPT_ECHOPRINT
     extern int B_echo(int, char*[],Shbltin_t*);
 #endif /* SHOPT_ECHOPRINT */
@@ -178,6 +180,7 @@ extern const char sh_optstop[];
 extern const char sh_optsuspend[];
 extern const char sh_optksh[];
 extern const char sh_optlet[];
+extern const char sh_optparmap[];
 extern const char sh_optprint[];
 extern const char sh_optprintf[];
 extern const char sh_optpwd[];
@@ -199,6 +202,7 @@ extern const char sh_optwait[];
 extern const char sh_optunset[];
 extern const char sh_optwhence[];
 extern const char sh_opttimes[];
+extern const char sh_opttracebuf[];
 
 extern const char e_dict[];
 
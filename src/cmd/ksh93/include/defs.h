@@ -95,6 +95,12 @@ extern char*	sh_setenviron(const char*);
 #define SH_READEVAL		0x4000	/* for sh_eval */
 #define SH_FUNEVAL		0x10000	/* for sh_eval for function load */
 
+/* event types for sh_trevent() */
+#define TR_START		1	/* simple command started */
+#define TR_END			2	/* simple command ended; must be TR_START+1 */
+#define TR_CALL			3	/* function called */
+#define TR_RETURN		4	/* function returned; must be TR_CALL+1 */
+
 extern char 		**sh_argbuild(int*,const struct comnod*,int);
 extern struct dolnod	*sh_argfree(struct dolnod*,int);
 extern struct dolnod	*sh_argnew(char*[],struct dolnod**);
@@ -127,6 +133,7 @@ extern void		sh_printopts(Shopt_t,int,Shopt_t*);
 extern int 		sh_readline(char**,volatile int,int,ssize_t,Sflong_t);
 extern Sfio_t		*sh_sfeval(char*[]);
 extern void		sh_setmatch(const char*,int,int,int[],int);
+extern int		sh_getmatch(Namval_t*);
 extern void             sh_scope(struct argnod*, int);
 extern Namval_t		*sh_scoped(Namval_t*);
 extern Dt_t		*sh_subtracktree(int);
@@ -138,6 +145,11 @@ extern char 		*sh_substitute(const char*,const char*,char*);
 extern void		sh_timetraps(void);
 extern const char	*_sh_translate(const char*);
 extern int		sh_trace(char*[],int);
+extern void		sh_trclear(void);
+extern void		sh_trevent(int,const char*,int,int);
+extern int		sh_trprint(Sfio_t*,Sfio_t*);
+extern void		sh_trsize(size_t);
+extern int		sh_trwrite(Sfio_t*);
 extern void		sh_trim(char*);
 extern int		sh_type(const char*);
 extern void             sh_unscope(void);
@@ -150,13 +162,38 @@ extern void             sh_unscope(void);
     extern Namval_t	*sh_fsearch(const char *,int);
 #endif /* SHOPT_NAMESPACE */
 
-/* malloc related wrappers */
-extern void		*sh_malloc(size_t size);
-extern void		*sh_realloc(void *ptr, size_t size);
-extern void		*sh_calloc(size_t nmemb, size_t size);
-extern char		*sh_strdup(const char *s);
-extern void		*sh_memdup(const void *s, size_t n);
+/*
+ * malloc related wrappers
+ * On SHOPT_STATS shells, allocations are counted in .sh.mem by subsystem.
+ * A source file selects its subsystem by defining MEM_TAG before defs.h;
+ * sh_mallocx() etc. take the subsystem as an argument.
+ */
+#define MEM_OTHER	0
+#define MEM_VARS	1
+#define MEM_ARRAYS	2
+#define MEM_PARSE	3
+#define MEM_FUNCS	4
+#define MEM_IO		5
+#define MEM_HIST	6
+#define MEM_NTAGS	7
+#define MEM_ALLOCS	0	/* number of allocations */
+#define MEM_BYTES	1	/* bytes allocated; realloc counts its growth */
+#define MEM_NCOUNT	2
+#define MEM_STAT(tag,n)	((tag)*MEM_NCOUNT+(n))
+#ifndef MEM_TAG
+#   define MEM_TAG	MEM_OTHER
+#endif
+extern void		*sh_mallocx(size_t size, int tag);
+extern void		*sh_reallocx(void *ptr, size_t size, int tag);
+extern void		*sh_callocx(size_t nmemb, size_t size, int tag);
+extern char		*sh_strdupx(const char *s, int tag);
+extern void		*sh_memdupx(const void *s, size_t n, int tag);
 extern char		*sh_getcwd(void);
+#define sh_malloc(s)	sh_mallocx(s,MEM_TAG)
+#define sh_realloc(p,s)	sh_reallocx(p,s,MEM_TAG)
+#define sh_calloc(n,s)	sh_callocx(n,s,MEM_TAG)
+#define sh_strdup(s)	sh_strdupx(s,MEM_TAG)
+#define sh_memdup(s,n)	sh_memdupx(s,n,MEM_TAG)
 #define new_of(type,x)	((type*)sh_malloc((unsigned)sizeof(type)+(x)))
 #define sh_newof(p,t,n,x)	((p)?(t*)sh_realloc((char*)(p),sizeof(t)*(n)+(x)):(t*)sh_calloc(1,sizeof(t)*(n)+(x)))
 
@@ -230,10 +267,25 @@ extern const char	e_scriptonly[];
 #   define	STAT_SCMDS	11
 #   define	STAT_SPAWN	12
 #   define	STAT_SUBSHELL	13
+    /* startup phases in microseconds */
+#   define	STAT_STARTUP	14
+#   define	STAT_STCONTEXT	15
+#   define	STAT_STNAMES	16
+#   define	STAT_STENV	17
+#   define	STAT_STOPTIONS	18
+#   define	STAT_STLOCALE	19
+#   define	STAT_STPROFILE	20
+    /* here-document storage */
+#   define	STAT_HEREMEM	21
+#   define	STAT_HERETMP	22
+#   define	STAT_NSTATS	23
     extern const Shtable_t shtab_stats[];
+    extern const Shtable_t shtab_mem[];
+    extern void sh_stats_startup(int);
 #   define sh_stats(x)	(sh.stats[(x)]++)
 #else
 #   define sh_stats(x)
+#   define sh_stats_startup(x)
 #endif /* SHOPT_STATS */
 
 #endif /* !defs_h_defined */
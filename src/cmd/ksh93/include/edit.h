@@ -149,6 +149,11 @@ typedef struct edit
 #define TINF_ERASE_EOS	"ed"
 #define TCAP_CURSOR_UP	"up"
 #define TCAP_ERASE_EOS	"cd"
+/* optional ones for shifting the rest of the line */
+#define TINF_INSERT_CHAR	"ich 1"
+#define TINF_DELETE_CHAR	"dch1"
+#define TCAP_INSERT_CHAR	"ic"
+#define TCAP_DELETE_CHAR	"dc"
 
 extern void	ed_putchar(Edit_t*, int);
 extern void	ed_putstring(Edit_t*, const char*);
@@ -164,6 +169,7 @@ extern int	ed_read(void*, int, char*, int, int);
 extern int	ed_emacsread(void*, int, char*, int, int);
 extern Edpos_t	ed_curpos(Edit_t*, genchar*, int, int, Edpos_t);
 extern int	ed_setcursor(Edit_t*, genchar*, int, int, int);
+extern int	ed_shift(Edit_t*, genchar*, int, int, const genchar*, int, int);
 #if SHOPT_ESH || SHOPT_VSH
 extern int	ed_macro(Edit_t*,int);
 #endif
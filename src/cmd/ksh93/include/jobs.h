@@ -42,6 +42,7 @@ struct process
 {
 	struct process *p_nxtjob;	/* next job structure */
 	struct process *p_nxtproc;	/* next process in current job */
+	struct process *p_nxthash;	/* next process in process ID hash chain */
 	int		*p_exitval;	/* place to store the exitval */
 	pid_t		p_pid;		/* process ID */
 	pid_t		p_pgrp;		/* process group */
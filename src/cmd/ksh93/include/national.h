@@ -26,6 +26,13 @@
 #   ifndef MARKER
 #	define MARKER		0xdfff	/* Must be invalid character */
 #   endif
+    /* nonzero if the locale is UTF-8; cached until the locale changes */
+#   define mbutf8()	(_sh_utf8serial==ast.locale.serial ? _sh_utf8 : sh_utf8init())
+    extern uint32_t	_sh_utf8serial;
+    extern int		_sh_utf8;
+    extern int		sh_utf8init(void);
+    extern size_t	sh_asciilen(const char*,size_t);
+    extern ssize_t	sh_utf8scan(const char*,size_t,size_t,size_t*);
 #endif /* SHOPT_MULTIBYTE */
 
 extern int sh_strchr(const char*,const char*);
@@ -399,6 +399,7 @@ struct Shell_s
 	char		nv_putsub_already_called_sh_arith;
 	int		nv_putsub_idx;	/* saves array index obtained by nv_putsub() using sh_arith() */
 	int16_t		level;		/* ${.sh.level} */
+	void		*tracebuf;	/* execution trace ring buffer for tracebuf built-in */
 #if SHOPT_STATS
 	int		*stats;
 #endif
@@ -119,6 +119,7 @@ struct swnod
 	struct regnod	*swlst;
 	struct ionod	*swio;
 	int		swline;
+	struct swhash	*swhash;	/* hash index of literal patterns, or NULL */
 };
 
 struct regnod
@@ -129,6 +130,29 @@ struct regnod
 	char		regflag;
 };
 
+/*
+ * Hash index built for a case statement whose arms mostly consist of
+ * literal (ARG_RAW) patterns. Each literal maps to the first arm that
+ * contains it; arms with any other pattern are kept in the 'slow' list
+ * and are still matched in order before a literal arm that follows them.
+ */
+#define SWHASH_MIN	8	/* minimum number of literals worth hashing */
+
+struct swent
+{
+	const char	*swkey;		/* literal pattern; NULL if unused */
+	struct regnod	*swreg;		/* case arm */
+	int		swnum;		/* ordinal of arm in case statement */
+};
+
+struct swhash
+{
+	unsigned int	swmask;		/* number of buckets - 1 */
+	int		swnslow;	/* number of arms in swslow */
+	struct swent	*swslow;	/* arms with non-literal patterns */
+	struct swent	swbucket[1];	/* swmask+1 buckets */
+};
+
 struct parnod
 {
 	int		partyp;
@@ -211,6 +235,7 @@ extern void			sh_freeup(void);
 extern void			sh_funstaks(struct slnod*,int);
 extern Sfio_t 			*sh_subshell(Shnode_t*, volatile int, int);
 extern int			sh_tdump(Sfio_t*, const Shnode_t*);
+extern struct swhash		*sh_swhash(struct regnod*);
 extern Shnode_t			*sh_trestore(Sfio_t*);
 
 #endif /* _SHNODES_H */
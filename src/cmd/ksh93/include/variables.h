@@ -106,11 +106,12 @@ extern void sh_save_rand_seed(struct rand *, int);
 #define SH_LEVELNOD	(sh.bltin_nodes+58)
 #define SH_LINENO	(sh.bltin_nodes+59)
 #define SH_STATS	(sh.bltin_nodes+60)
-#define SH_MATHNOD	(sh.bltin_nodes+61)
-#define SH_PIDNOD	(sh.bltin_nodes+62)
-#define SH_PPIDNOD	(sh.bltin_nodes+63)
-#define SH_TILDENOD	(sh.bltin_nodes+64)
-#define SHLVL		(sh.bltin_nodes+65)
-#define SRANDNOD	(sh.bltin_nodes+66)
+#define SH_MEMNOD	(sh.bltin_nodes+61)
+#define SH_MATHNOD	(sh.bltin_nodes+62)
+#define SH_PIDNOD	(sh.bltin_nodes+63)
+#define SH_PPIDNOD	(sh.bltin_nodes+64)
+#define SH_TILDENOD	(sh.bltin_nodes+65)
+#define SHLVL		(sh.bltin_nodes+66)
+#define SRANDNOD	(sh.bltin_nodes+67)
 
 #endif /* SH_VALNOD */
@@ -75,10 +75,15 @@ static const int flagval[]  =
 
 #define NUM_OPTS	(sizeof(flagval)/sizeof(*flagval))
 
+#define DOLPOOL		256	/* size of argument blocks kept for reuse */
+#define DOLPOOLMAX	16	/* maximum number of blocks kept for reuse */
+
 typedef struct _arg_
 {
 	struct dolnod	*argfor; /* linked list of blocks to be cleaned up */
 	struct dolnod	*dolh;
+	struct dolnod	*dolpool; /* free list of DOLPOOL-sized blocks */
+	int		npool;
 	char flagadr[NUM_OPTS+1];
 #if SHOPT_KIA
 	char	*kiafile;
@@ -460,7 +465,14 @@ struct dolnod *sh_argfree(struct dolnod *blk,int flag)
 					argr->dolnxt = argblk->dolnxt;
 					argr = argblk->dolnxt;
 				}
-				free(argblk);
+				if(argblk->dolmax==DOLPOOL && ap->npool<DOLPOOLMAX)
+				{
+					argblk->dolnxt = ap->dolpool;
+					ap->dolpool = argblk;
+					ap->npool++;
+				}
+				else
+					free(argblk);
 			}
 		}
 	}
@@ -470,9 +482,11 @@ struct dolnod *sh_argfree(struct dolnod *blk,int flag)
 /*
  * grab space for arglist and copy args
  * The strings are copied after the argument vector
+ * Small lists use a recycled block of DOLPOOL bytes if one is available
  */
 struct dolnod *sh_argcreate(char *argv[])
 {
+	Arg_t *ap = (Arg_t*)sh.arg_context;
 	struct dolnod *dp;
 	char **pp=argv, *sp;
 	int 	n;
@@ -481,7 +495,23 @@ struct dolnod *sh_argcreate(char *argv[])
 	while(sp= *pp++)
 		size += strlen(sp);
 	n = (pp - argv)-1;
-	dp=new_of(struct dolnod,n*sizeof(char*)+size+n);
+	size += n*sizeof(char*)+n;
+	if(size > DOLPOOL)
+	{
+		dp = new_of(struct dolnod,size);
+		dp->dolmax = 0;
+	}
+	else
+	{
+		if(dp = ap->dolpool)
+		{
+			ap->dolpool = dp->dolnxt;
+			ap->npool--;
+		}
+		else
+			dp = new_of(struct dolnod,DOLPOOL);
+		dp->dolmax = DOLPOOL;
+	}
 	dp->dolrefcnt=1;	/* use count */
 	dp->dolnum = n;
 	dp->dolnxt = 0;
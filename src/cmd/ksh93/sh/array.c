@@ -26,6 +26,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_ARRAYS
 #include	"defs.h"
 #include	"name.h"
 #include	<ast_release.h>
@@ -907,9 +908,12 @@ int nv_atypeindex(Namval_t *np, const char *tname)
 
 Namarr_t *nv_arrayptr(Namval_t *np)
 {
-	if(nv_isattr(np,NV_ARRAY))
-		return (Namarr_t*)nv_hasdisc(np, &array_disc);
-	return NULL;
+	Namarr_t	*ap;
+	if(!nv_isattr(np,NV_ARRAY))
+		return NULL;
+	if(!(ap = (Namarr_t*)nv_hasdisc(np, &array_disc)) && sh_getmatch(np))
+		ap = (Namarr_t*)nv_hasdisc(np, &array_disc);
+	return ap;
 }
 
 /*
@@ -31,6 +31,7 @@
 #include	<glob.h>
 #include	<ls.h>
 #include	<ast_dir.h>
+#include	<tmx.h>
 #include	"io.h"
 #include	"path.h"
 
@@ -39,6 +40,59 @@ static	const char	*sufstr;
 static	int		suflen;
 static	int		scantree(Dt_t*,const char*, struct argnod**);
 
+/*
+ * Completion cache
+ * The names read from a directory during completion are kept and reused
+ * by later completions for as long as the directory's modification time
+ * stays the same, so that pressing Tab again or narrowing the prefix costs
+ * a stat(2) of each directory instead of reading it again. Command
+ * completion also keeps the file types of the commands found in $PATH.
+ * These can change without the directory changing, so they are forgotten,
+ * along with everything else, whenever the hash table of tracked aliases
+ * is cleared (see path_compreset()).
+ */
+#define COMP_MAXDIRS	64		/* start over when more are cached */
+#define COMP_RACY	((Time_t)2000000000)	/* ignore mtimes this close to reading */
+#define COMP_NOTDIR	0x80		/* name is known not to be a directory */
+#define COMP_TYPED	0x40		/* low bits give the gl_type() value */
+
+typedef struct _compkey_
+{
+	dev_t		dev;
+	ino_t		ino;
+} Compkey_t;
+
+typedef struct _compdir_
+{
+	Dtlink_t	link;
+	Compkey_t	key;
+	Time_t		mtime;		/* mtime when read; 0 if not to be reused */
+	int		nnames;
+	char		**names;
+	unsigned char	*flags;		/* COMP_* flags for each name */
+	Sfio_t		*strings;	/* name strings */
+} Compdir_t;
+
+typedef struct _compscan_
+{
+	Compdir_t	*dp;
+	int		next;		/* index of the next name */
+} Compscan_t;
+
+static void	comp_free(Dt_t*, void*, Dtdisc_t*);
+static void	*comp_diropen(glob_t*, const char*);
+static char	*comp_dirnext(glob_t*, void*);
+static void	comp_dirclose(glob_t*, void*);
+static int	comp_type(glob_t*, const char*, int);
+
+static Dt_t		*compdict;
+static Compdir_t	*compcur;	/* directory being scanned */
+static int		compind;	/* index of the name last returned, or -1 */
+static Dtdisc_t		compdisc =
+{
+	offsetof(Compdir_t,key), sizeof(Compkey_t), offsetof(Compdir_t,link), 0, comp_free
+};
+
 
 /*
  * This routine builds a list of files that match a given pathname
@@ -89,6 +143,13 @@ int path_expand(const char *pattern, struct argnod **arghead, int musttrim)
 	}
 	if(sh_isstate(SH_FCOMPLETE))	/* file name completion */
 		flags |= GLOB_FCOMPLETE;
+	if(sh_isstate(SH_COMPLETE) || sh_isstate(SH_FCOMPLETE))
+	{
+		gp->gl_diropen = comp_diropen;
+		gp->gl_dirnext = comp_dirnext;
+		gp->gl_dirclose = comp_dirclose;
+		gp->gl_type = comp_type;
+	}
 	gp->gl_fignore = nv_getval(sh_scoped(FIGNORENOD));
 	if(suflen)
 		gp->gl_suffix = sufstr;
@@ -162,6 +223,176 @@ static int scantree(Dt_t *tree, const char *pattern, struct argnod **arghead)
 	return nmatch;
 }
 
+static void comp_free(Dt_t *dict, void *obj, Dtdisc_t *disc)
+{
+	Compdir_t *dp = (Compdir_t*)obj;
+	NOT_USED(dict);
+	NOT_USED(disc);
+	if(dp==compcur)
+		compcur = 0;
+	sfclose(dp->strings);
+	free(dp->names);
+	free(dp->flags);
+	free(dp);
+}
+
+/*
+ * read directory <dir> with status <sp> into a new cache entry
+ */
+static Compdir_t *comp_read(const char *dir, struct stat *sp, Compkey_t *kp)
+{
+	Compdir_t	*dp;
+	DIR		*dirf;
+	struct dirent	*ep;
+	size_t		*offs=0;
+	char		*base;
+	int		n, max=0;
+	Time_t		now = tmxgettime();
+	if(!(dirf = opendir(dir)))
+		return NULL;
+	dp = sh_newof(0,Compdir_t,1,0);
+	dp->key = *kp;
+	dp->mtime = tmxgetmtime(sp);
+	/* a directory changed just before it was read may change again without a new mtime */
+	if(dp->mtime==0 || dp->mtime > now-COMP_RACY)
+		dp->mtime = 0;
+	if(!(dp->strings = sfstropen()))
+	{
+		closedir(dirf);
+		free(dp);
+		return NULL;
+	}
+	while(ep = readdir(dirf))
+	{
+		if(dp->nnames >= max)
+		{
+			max = max ? 2*max : 64;
+			offs = sh_realloc(offs,max*sizeof(size_t));
+			dp->flags = sh_realloc(dp->flags,max);
+		}
+		offs[dp->nnames] = sfstrtell(dp->strings);
+		dp->flags[dp->nnames] = 0;
+#ifdef D_TYPE
+		if(D_TYPE(ep) != DT_UNKNOWN && D_TYPE(ep) != DT_DIR && D_TYPE(ep) != DT_LNK)
+			dp->flags[dp->nnames] = COMP_NOTDIR;
+#endif
+		sfputr(dp->strings,ep->d_name,0);
+		dp->nnames++;
+	}
+	closedir(dirf);
+	dp->names = sh_malloc((dp->nnames+1)*sizeof(char*));
+	base = sfstrbase(dp->strings);
+	for(n=0; n < dp->nnames; n++)
+		dp->names[n] = base + offs[n];
+	free(offs);
+	return dp;
+}
+
+/*
+ * gl_diropen discipline for completion: use or refresh the cached names
+ */
+static void *comp_diropen(glob_t *gp, const char *dir)
+{
+	Compscan_t	*cp;
+	Compdir_t	*dp;
+	Compkey_t	key;
+	struct stat	statb;
+	NOT_USED(gp);
+	if(stat(dir,&statb) < 0)
+		return NULL;
+	if(!S_ISDIR(statb.st_mode))
+	{
+		errno = ENOTDIR;
+		return NULL;
+	}
+	if(!compdict && !(compdict = dtopen(&compdisc,Dtset)))
+		return NULL;
+	memset(&key,0,sizeof(key));
+	key.dev = statb.st_dev;
+	key.ino = statb.st_ino;
+	if((dp = (Compdir_t*)dtmatch(compdict,&key)) && (!dp->mtime || dp->mtime!=tmxgetmtime(&statb)))
+	{
+		dtdelete(compdict,dp);
+		dp = 0;
+	}
+	if(!dp)
+	{
+		if(!(dp = comp_read(dir,&statb,&key)))
+			return NULL;
+		if(dtsize(compdict) >= COMP_MAXDIRS)
+			dtclear(compdict);
+		dtinsert(compdict,dp);
+	}
+	cp = sh_newof(0,Compscan_t,1,0);
+	cp->dp = compcur = dp;
+	compind = -1;
+	return cp;
+}
+
+static char *comp_dirnext(glob_t *gp, void *handle)
+{
+	Compscan_t	*cp = (Compscan_t*)handle;
+	Compdir_t	*dp = cp->dp;
+	if(cp->next >= dp->nnames)
+	{
+		errno = 0;
+		return NULL;
+	}
+	compind = cp->next++;
+	if(dp->flags[compind]&COMP_NOTDIR)
+		gp->gl_status |= GLOB_NOTDIR;
+	return dp->names[compind];
+}
+
+static void comp_dirclose(glob_t *gp, void *handle)
+{
+	NOT_USED(gp);
+	compcur = 0;
+	free(handle);
+}
+
+/*
+ * gl_type discipline for completion
+ * during command completion the type of the name just read is cached
+ */
+static int comp_type(glob_t *gp, const char *path, int flags)
+{
+	int		type;
+	unsigned char	*fp = 0;
+	struct stat	statb;
+	NOT_USED(gp);
+	if(compcur && compind>=0 && sh_isstate(SH_COMPLETE) && !(flags&GLOB_STARSTAR) && strcmp(path_basename(path),compcur->names[compind])==0)
+	{
+		fp = &compcur->flags[compind];
+		if(*fp&COMP_TYPED)
+			return *fp&~(COMP_NOTDIR|COMP_TYPED);
+	}
+	if((flags&GLOB_STARSTAR) ? lstat(path,&statb) : stat(path,&statb))
+		type = 0;
+	else if(S_ISDIR(statb.st_mode))
+		type = GLOB_DIR;
+	else if(S_ISLNK(statb.st_mode))
+		type = GLOB_SYM;
+	else if(!S_ISREG(statb.st_mode))
+		type = GLOB_DEV;
+	else if(statb.st_mode & (S_IXUSR|S_IXGRP|S_IXOTH))
+		type = GLOB_EXE;
+	else
+		type = GLOB_REG;
+	if(fp)
+		*fp |= COMP_TYPED|type;
+	return type;
+}
+
+/*
+ * forget all cached completions; called when the hash table is cleared
+ */
+void path_compreset(void)
+{
+	if(compdict)
+		dtclear(compdict);
+}
+
 /*
  * file name completion
  * generate the list of files found by adding an suffix to end of name
@@ -661,6 +661,9 @@ noreturn void sh_done(int sig)
 	job_close();
 	sfsync((Sfio_t*)sfstdin);
 	sfsync((Sfio_t*)sh.outpool);
+	/* report a failure to write output that print left in the buffer */
+	if(sfstdout->_next > sfstdout->_data && sfsync((Sfio_t*)sfstdout) < 0 && savxit==0)
+		savxit = 1;
 	sfsync((Sfio_t*)sfstdout);
 	if((sh.chldexitsig && sh.realsubshell) || (savxit&SH_EXITSIG && (savxit&SH_EXITMASK) == savlastsig))
 		sig = savxit&SH_EXITMASK;
@@ -28,6 +28,7 @@
 #include	<sfio.h>
 #include	<error.h>
 #include	<fcin.h>
+#include	"national.h"
 
 Fcin_t _Fcin = {0};
 
@@ -148,6 +149,12 @@ extern void fcrestore(Fcin_t *fp)
 int _fcmbget(short *len)
 {
 	int	c;
+	if(mbutf8() && !(*_Fcin.fcptr & 0x80))
+	{
+		/* ASCII is a single byte in UTF-8 */
+		*len = *_Fcin.fcptr != 0;
+		return fcget();
+	}
 	switch(*len = mbsize(_Fcin.fcptr))
 	{
 	    case -1:
@@ -48,6 +48,9 @@
 #include	"FEATURE/externs"
 #include	"lexstates.h"
 #include	"version.h"
+#if SHOPT_STATS && _lib_malloc_usable_size
+#include	<malloc.h>
+#endif
 
 #ifdef BUILD_DTKSH
 #include <Dt/DtNlUtils.h>
@@ -174,9 +177,17 @@ struct match
 	int		msize;
 	int		nmatch;
 	int		index;
+	int		pending;
 	int		lastsub[2];
 };
 
+/*
+ * parts of the .sh.match array that sh_setmatch() left for sh_getmatch()
+ */
+#define MATCH_INIT	1	/* subscripts of the first match */
+#define MATCH_2D	2	/* two dimensional array, from the second match */
+#define MATCH_END	4	/* subscripts of the other matches */
+
 typedef struct _init_
 {
 	struct ifs	IFS_init;
@@ -215,6 +226,7 @@ static void		env_init(void);
 static Init_t		*nv_init(void);
 #if SHOPT_STATS
 static void		stat_init(void);
+static void		mem_init(void);
 #endif
 
 /*
@@ -226,52 +238,83 @@ static noreturn void *nomemory(size_t s)
 	UNREACHABLE();
 }
 
+#if SHOPT_STATS
+/*
+ * The counters for .sh.mem, MEM_NCOUNT for each subsystem followed by the
+ * current and peak bytes held by stk(3). Counting is two additions per
+ * allocation; frees are not tracked, so bytes in use are only known for stk.
+ */
+static Sflong_t	memstats[MEM_STAT(MEM_NTAGS,2)];
+#   define mem_count(size,tag)	(memstats[MEM_STAT(tag,MEM_ALLOCS)]++, memstats[MEM_STAT(tag,MEM_BYTES)] += (size))
+#else
+#   define mem_count(size,tag)
+#endif /* SHOPT_STATS */
+
 /*
  * The following are wrapper functions for memory allocation.
  * These functions will error out if the allocation fails.
+ * They are called through the sh_malloc() etc. macros in defs.h.
  */
-void *sh_malloc(size_t size)
+void *sh_mallocx(size_t size, int tag)
 {
 	void *cp;
+	NOT_USED(tag);
 	cp = malloc(size);
 	if(!cp)
 		nomemory(size);
+	mem_count(size,tag);
 	return cp;
 }
 
-void *sh_realloc(void *ptr, size_t size)
+void *sh_reallocx(void *ptr, size_t size, int tag)
 {
 	void *cp;
+	size_t old = 0;
+	NOT_USED(tag);
+#if SHOPT_STATS && _lib_malloc_usable_size
+	/* count only the growth where the old size can be had cheaply */
+	if(ptr)
+		old = malloc_usable_size(ptr);
+#endif
 	cp = realloc(ptr, size);
 	if(!cp)
 		nomemory(size);
+	mem_count(size > old ? size-old : 0,tag);
+	NOT_USED(old);
 	return cp;
 }
 
-void *sh_calloc(size_t nmemb, size_t size)
+void *sh_callocx(size_t nmemb, size_t size, int tag)
 {
 	void *cp;
+	NOT_USED(tag);
 	cp = calloc(nmemb, size);
 	if(!cp)
 		nomemory(size);
+	mem_count(nmemb*size,tag);
 	return cp;
 }
 
-char *sh_strdup(const char *s)
+char *sh_strdupx(const char *s, int tag)
 {
 	char *dup;
-	dup = strdup(s);
+	size_t n = strlen(s) + 1;
+	NOT_USED(tag);
+	dup = malloc(n);
 	if(!dup)
-		nomemory(strlen(s)+1);
-	return dup;
+		nomemory(n);
+	mem_count(n,tag);
+	return memcpy(dup, s, n);
 }
 
-void *sh_memdup(const void *s, size_t n)
+void *sh_memdupx(const void *s, size_t n, int tag)
 {
 	void *dup;
+	NOT_USED(tag);
 	dup = memdup(s, n);
 	if(!dup)
 		nomemory(n);
+	mem_count(n,tag);
 	return dup;
 }
 
@@ -389,6 +432,7 @@ static void put_restricted(Namval_t* np,const char *val,int flags,Namfun_t *fp)
 	{
 		/* Clear the hash table */
 		nv_scan(sh_subtracktree(1),nv_rehash,NULL,NV_TAGGED,NV_TAGGED);
+		path_compreset();
 		if(path_scoped && !val)
 			val = PATHNOD->nvalue;
 	}
@@ -825,51 +869,95 @@ static void match2d(struct match *mp)
 		ap->nelem = mp->nmatch;
 }
 
+/*
+ * add the subscripts of all matches of a global substitution
+ */
+static void matchend(struct match *mp)
+{
+	Namval_t	*np = nv_namptr(mp->nodes,0);
+	Namarr_t	*ap;
+	int		i,n,x;
+	if(mp->index==0)
+		match2d(mp);
+	for(i=0; i < mp->nmatch; i++)
+	{
+		nv_disc(np,&mp->hdr,NV_LAST);
+		nv_putsub(np,NULL,mp->index);
+		for(x=mp->index; x >=0; x--)
+		{
+			n = i + x*mp->nmatch;
+			if(mp->match[2*n+1]>mp->match[2*n])
+				nv_putsub(np,Empty,ARRAY_ADD|x);
+		}
+		if((ap=nv_arrayptr(np)) && array_elem(ap)==0)
+		{
+			nv_putsub(SH_MATCHNOD,NULL,i);
+			_nv_unset(SH_MATCHNOD,NV_RDONLY);
+		}
+		np = nv_namptr(np+1,0);
+	}
+}
+
+/*
+ * build the parts of the .sh.match array left pending by sh_setmatch()
+ * called by nv_arrayptr() when .sh.match is first used as an array
+ * returns 0 if <np> is not .sh.match or there was nothing to build
+ */
+int sh_getmatch(Namval_t *np)
+{
+	Init_t		*ip = sh.init_context;
+	struct match	*mp = &ip->SH_MATCH_init;
+	int		i, pending=mp->pending, savesub=sh.subshell;
+	if(np!=SH_MATCHNOD || !pending)
+		return 0;
+	mp->pending = 0;
+	sh.subshell = 0;
+	mp->nodes = sh_calloc(mp->nmatch*(NV_MINSZ+sizeof(void*)+3),1);
+	mp->names = mp->nodes + mp->nmatch*(NV_MINSZ+sizeof(void*));
+	for(i=mp->nmatch; --i>=0;)
+	{
+		if(mp->match[2*i]>=0)
+			nv_putsub(SH_MATCHNOD,Empty,ARRAY_ADD|i);
+	}
+	if(pending&MATCH_2D)
+		match2d(mp);
+	if(pending&MATCH_END)
+		matchend(mp);
+	sh.subshell = savesub;
+	return 1;
+}
+
 /*
  * store the most recent value for use in .sh.match
  * treat .sh.match as a two dimensional array
+ * the array itself is only built by sh_getmatch() when it is used, as
+ * many matches happen in scripts that never look at .sh.match
  */
 void sh_setmatch(const char *v, int vsize, int nmatch, int match[], int index)
 {
 	Init_t		*ip = sh.init_context;
 	struct match	*mp = &ip->SH_MATCH_init;
-	int		i,n,x, savesub=sh.subshell;
-	Namarr_t	*ap = nv_arrayptr(SH_MATCHNOD);
+	int		i,n, savesub=sh.subshell;
+	Namarr_t	*ap;
 	Namval_t	*np;
 	if(sh.intrace)
 		return;
 	sh.subshell = 0;
 	if(index<0)
 	{
-		if(mp->nodes)
-		{
-			np = nv_namptr(mp->nodes,0);
-			if(mp->index==0)
-				match2d(mp);
-			for(i=0; i < mp->nmatch; i++)
-			{
-				nv_disc(np,&mp->hdr,NV_LAST);
-				nv_putsub(np,NULL,mp->index);
-				for(x=mp->index; x >=0; x--)
-				{
-					n = i + x*mp->nmatch;
-					if(mp->match[2*n+1]>mp->match[2*n])
-						nv_putsub(np,Empty,ARRAY_ADD|x);
-				}
-				if((ap=nv_arrayptr(np)) && array_elem(ap)==0)
-				{
-					nv_putsub(SH_MATCHNOD,NULL,i);
-					_nv_unset(SH_MATCHNOD,NV_RDONLY);
-				}
-				np = nv_namptr(np+1,0);
-			}
-		}
+		if(mp->pending)
+			mp->pending |= MATCH_END;
+		else if(mp->nodes)
+			matchend(mp);
 		sh.subshell = savesub;
 		return;
 	}
 	mp->index = index;
 	if(index==0)
 	{
+		/* a pending array has no nodes and no array to free */
+		ap = mp->pending ? NULL : nv_arrayptr(SH_MATCHNOD);
+		mp->pending = 0;
 		if(mp->nodes)
 		{
 			np = nv_namptr(mp->nodes,0);
@@ -895,21 +983,17 @@ void sh_setmatch(const char *v, int vsize, int nmatch, int match[], int index)
 			sh.subshell = savesub;
 			return;
 		}
-		mp->nodes = sh_calloc(mp->nmatch*(NV_MINSZ+sizeof(void*)+3),1);
-		mp->names = mp->nodes + mp->nmatch*(NV_MINSZ+sizeof(void*));
-		np = nv_namptr(mp->nodes,0);
 		nv_disc(SH_MATCHNOD,&mp->hdr,NV_LAST);
-		for(i=nmatch; --i>=0;)
-		{
-			if(match[2*i]>=0)
-				nv_putsub(SH_MATCHNOD,Empty,ARRAY_ADD|i);
-		}
+		nv_onattr(SH_MATCHNOD,NV_ARRAY);
+		mp->pending = MATCH_INIT;
 		mp->v = v;
 		mp->first = match[0];
 	}
-	else
+	else if(index==1)
 	{
-		if(index==1)
+		if(mp->pending)
+			mp->pending |= MATCH_2D;
+		else
 			match2d(mp);
 	}
 	sh.subshell = savesub;
@@ -1231,6 +1315,10 @@ Shell_t *sh_init(int argc,char *argv[], Shinit_f userinit)
 	int type = 0;
 	static char *login_files[2];
 	sh_onstate(SH_INIT);
+#if SHOPT_STATS
+	sh.stats = (int*)sh_calloc(sizeof(int),STAT_NSTATS);
+	sh_stats_startup(-1);
+#endif
 	/* truncate final " $\0\n" from e_version for ${.sh.version} output (it's there for what(1) or ident(1)) */
 	e_version[sizeof e_version - 5] = '\0';
 	sh.current_pid = sh.pid = getpid();
@@ -1261,8 +1349,10 @@ Shell_t *sh_init(int argc,char *argv[], Shinit_f userinit)
 	sh_ioinit();
 	/* initialize signal handling */
 	sh_siginit();
+	sh_stats_startup(STAT_STCONTEXT);
 	/* set up memory for name-value pairs */
 	sh.init_context = nv_init();
+	sh_stats_startup(STAT_STNAMES);
 	/* initialize shell type */
 	if(argc>0)
 	{
@@ -1277,6 +1367,7 @@ Shell_t *sh_init(int argc,char *argv[], Shinit_f userinit)
 	}
 	/* read the environment */
 	env_init();
+	sh_stats_startup(STAT_STENV);
 	if(!ENVNOD->nvalue)
 	{
 		sfprintf(sh.strbuf,"%s/.kshrc",nv_getval(HOME));
@@ -1586,6 +1677,7 @@ void sh_reinit(void)
 	freeup_tree(sh.var_tree);
 #if SHOPT_STATS
 	free(sh.stats);
+	sh.stats = NULL;
 #endif
 	/* Re-init variables, functions and built-ins */
 	free(sh.bltin_cmds);
@@ -1643,7 +1735,7 @@ static Namval_t *create_stat(Namval_t *np,const char *name,int flag,Namfun_t *fp
 	Namval_t		*nq=0;
 	NOT_USED(flag);
 	if(!name)
-		return SH_STATS;
+		return np;
 	while((i=*cp++) && i != '=' && i != '+' && i!='[');
 	n = (cp-1) -name;
 	for(i=0; i < sp->numnodes; i++)
@@ -1657,7 +1749,7 @@ found:
 	if(nq)
 	{
 		fp->last = (char*)&name[n];
-		sh.last_table = SH_STATS;
+		sh.last_table = np;
 	}
 	else
 	{
@@ -1693,15 +1785,35 @@ static Namfun_t	 stat_child_fun =
 	&stat_child_disc, 1, 0, sizeof(Namfun_t)
 };
 
+/*
+ * Record the microseconds spent in a startup phase, i.e., since the
+ * previous call, in .sh.stats; stat < 0 marks the start of startup.
+ */
+void sh_stats_startup(int stat)
+{
+	static Tv_t	start, prev;
+	Tv_t		now;
+	tvgettime(&now);
+	if(stat < 0)
+		start = now;
+	else
+	{
+		sh.stats[stat] = (int)((((Sflong_t)now.tv_sec - prev.tv_sec) * 1000000000 + now.tv_nsec - prev.tv_nsec) / 1000);
+		sh.stats[STAT_STARTUP] = (int)((((Sflong_t)now.tv_sec - start.tv_sec) * 1000000000 + now.tv_nsec - start.tv_nsec) / 1000);
+	}
+	prev = now;
+}
+
 static void stat_init(void)
 {
-	int		i,nstat = STAT_SUBSHELL+1;
+	int		i,nstat = STAT_NSTATS;
 	size_t		extrasize = nstat*(sizeof(int)+NV_MINSZ);
 	struct Stats	*sp = sh_newof(0,struct Stats,1,extrasize);
 	Namval_t	*np;
 	sp->numnodes = nstat;
 	sp->nodes = (char*)(sp+1);
-	sh.stats = (int*)sh_calloc(sizeof(int),nstat);
+	if(!sh.stats)
+		sh.stats = (int*)sh_calloc(sizeof(int),nstat);
 	for(i=0; i < nstat; i++)
 	{
 		np = nv_namptr(sp->nodes,i);
@@ -1717,6 +1829,75 @@ static void stat_init(void)
 	sp->hdr.nofree = 1;
 	nv_setvtree(SH_STATS);
 }
+
+/*
+ * .sh.mem reports the counters kept by sh_mallocx() and friends,
+ * followed by the bytes currently held and the peak held by stk(3).
+ * The get disciplines also keep the loop invariants optimizer away.
+ */
+static void mem_update(void)
+{
+	size_t	peak;
+	memstats[MEM_STAT(MEM_NTAGS,0)] = stkused(&peak);
+	memstats[MEM_STAT(MEM_NTAGS,1)] = peak;
+}
+
+static char *get_mem(Namval_t *np, Namfun_t *fp)
+{
+	mem_update();
+	return nv_getv(np,fp);
+}
+
+static Sfdouble_t nget_mem(Namval_t *np, Namfun_t *fp)
+{
+	mem_update();
+	return nv_getn(np,fp);
+}
+
+static char *name_mem(Namval_t *np, Namfun_t *fp)
+{
+	NOT_USED(fp);
+	sfprintf(sh.strbuf,".sh.mem.%s",np->nvname);
+	return sfstruse(sh.strbuf);
+}
+
+static const Namdisc_t	mem_child_disc =
+{
+	0,0,
+	get_mem,
+	nget_mem,
+	0,0,0,
+	name_mem
+};
+
+static Namfun_t	 mem_child_fun =
+{
+	&mem_child_disc, 1, 0, sizeof(Namfun_t)
+};
+
+static void mem_init(void)
+{
+	int		i,nstat = elementsof(memstats);
+	size_t		extrasize = nstat*NV_MINSZ;
+	struct Stats	*sp = sh_newof(0,struct Stats,1,extrasize);
+	Namval_t	*np;
+	sp->numnodes = nstat;
+	sp->nodes = (char*)(sp+1);
+	for(i=0; i < nstat; i++)
+	{
+		np = nv_namptr(sp->nodes,i);
+		np->nvfun = &mem_child_fun;
+		np->nvname = (char*)shtab_mem[i].sh_name;
+		nv_onattr(np,NV_RDONLY|NV_MINIMAL|NV_NOFREE|NV_INT64);
+		nv_setsize(np,10);
+		np->nvalue = &memstats[shtab_mem[i].sh_number];
+	}
+	sp->hdr.dsize = sizeof(struct Stats) + extrasize;
+	sp->hdr.disc = &stat_disc;
+	nv_stack(SH_MEMNOD,&sp->hdr);
+	sp->hdr.nofree = 1;
+	nv_setvtree(SH_MEMNOD);
+}
 #endif /* SHOPT_STATS */
 
 /*
@@ -1825,7 +2006,7 @@ static Init_t *nv_init(void)
 	OPTINDNOD->nvalue = &sh.st.optindex;
 	SH_LEVELNOD->nvalue = &sh.level;
 	sh.alias_tree = dtopen(&_Nvdisc,Dtoset);
-	sh.track_tree = dtopen(&_Nvdisc,Dtset);
+	sh.track_tree = dtopen(&_Nvdisc,Dtpset);
 	sh.bltin_tree = sh_inittree((const struct shtable2*)shtab_builtins);
 	sh.fun_base = sh.fun_tree = dtopen(&_Nvdisc,Dtoset);
 	dtview(sh.fun_tree,sh.bltin_tree);
@@ -1845,6 +2026,7 @@ static Init_t *nv_init(void)
 	math_init();
 #if SHOPT_STATS
 	stat_init();
+	mem_init();
 #endif
 	return ip;
 }
@@ -1934,6 +2116,7 @@ static void env_init(void)
 	path_pwd();
 	if((cp = nv_getval(SHELLNOD)) && (sh_type(cp)&SH_TYPE_RESTRICTED))
 		sh_onoption(SH_RESTRICTED); /* restricted shell */
+	sh_stats_startup(STAT_STOPTIONS);
 	/*
 	 * Since AST setlocale() may use the environment (PATH, _AST_FEATURES),
 	 * defer setting locale until all of the environment has been imported.
@@ -1947,6 +2130,7 @@ static void env_init(void)
 		free(p);
 	}
 	sh_offstate(SH_LCINIT);
+	sh_stats_startup(STAT_STLOCALE);
 }
 
 /*
@@ -27,6 +27,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_IO
 #include	"defs.h"
 #include	<fcin.h>
 #include	<ls.h>
@@ -45,6 +46,10 @@
 #include	"FEATURE/dynamic"
 #include	"FEATURE/poll"
 
+#if _lib_memfd_create
+#   include	<sys/mman.h>
+#endif
+
 #ifdef	FNDELAY
 #   ifdef EAGAIN
 #	if EAGAIN!=EWOULDBLOCK
@@ -63,6 +68,10 @@
 #   define O_SERVICE	O_NOCTTY
 #endif
 
+#ifndef SOMAXCONN
+#   define SOMAXCONN	128	/* listen(2) backlog for /dev/tcp services */
+#endif
+
 #ifndef ERROR_PIPE
 #ifdef ECONNRESET
 #define ERROR_PIPE(e)	((e)==EPIPE||(e)==ECONNRESET||(e)==EIO)
@@ -295,7 +304,7 @@ inetopen(const char* path, int flags)
 			p->ai_socktype = hint.ai_socktype;
 		while ((fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) >= 0)
 		{
-			if (server && !bind(fd, p->ai_addr, p->ai_addrlen) && !listen(fd, 5) || !server && !connect(fd, p->ai_addr, p->ai_addrlen))
+			if (server && !bind(fd, p->ai_addr, p->ai_addrlen) && !listen(fd, SOMAXCONN) || !server && !connect(fd, p->ai_addr, p->ai_addrlen))
 				goto done;
 			close(fd);
 			fd = -1;
@@ -1561,6 +1570,37 @@ fail:
 	errormsg(SH_DICT,ERROR_system(1),message,fname);
 	UNREACHABLE();
 }
+/*
+ * Create an unnamed seekable file for the contents of a here-document.
+ * Where available, this is an anonymous memory file, which avoids creating
+ * and removing a directory entry; otherwise it is an sftmp(3) temporary file.
+ */
+static Sfio_t *io_heretmp(void)
+{
+	Sfio_t	*outfile;
+#if _lib_memfd_create
+	static char	nomemfd;
+	int		fd;
+	if(!nomemfd)
+	{
+		if((fd = memfd_create("sh-heredoc",0)) >= 0)
+		{
+			if(outfile = sfnew(NULL,NULL,SFIO_UNBOUND,fd,SFIO_READ|SFIO_WRITE))
+			{
+				sh_stats(STAT_HEREMEM);
+				return outfile;
+			}
+			close(fd);
+		}
+		else if(errno==ENOSYS || errno==EPERM)
+			nomemfd = 1;	/* not supported by kernel or blocked by seccomp */
+	}
+#endif /* _lib_memfd_create */
+	if(outfile = sftmp(0))
+		sh_stats(STAT_HERETMP);
+	return outfile;
+}
+
 /*
  * Create a tmp file for the here-document
  */
@@ -1572,7 +1612,7 @@ static int io_heredoc(struct ionod *iop, const char *name, int traceon)
 	if(!(iop->iofile&IOSTRG) && (!sh.heredocs || iop->iosize==0))
 		return sh_open(e_devnull,O_RDONLY);
 	/* create an unnamed temporary file */
-	if(!(outfile=sftmp(0)))
+	if(!(outfile=io_heretmp()))
 	{
 		errormsg(SH_DICT,ERROR_system(1),e_tmpcreate);
 		UNREACHABLE();
@@ -1762,6 +1802,7 @@ void	sh_iounsave(void)
  */
 void	sh_iorestore(int last, int jmpval)
 {
+	Sfio_t *sp;
 	int origfd, savefd, fd;
 	int flag = (last&IOSUBSHELL);
 	last &= ~IOSUBSHELL;
@@ -1794,6 +1835,9 @@ void	sh_iorestore(int last, int jmpval)
 		}
 		else if(filemap[fd].tname)
 			io_usename(filemap[fd].tname,NULL,origfd,sh.exitval?2:1);
+		/* report a failure to write output that print left in the buffer */
+		if(origfd==1 && (sp = sh.sftable[1]) && sp->_next > sp->_data && sfsync(sp) < 0 && sh.exitval==0)
+			sh.exitval = 1;
 		sh_close(origfd);
 		if ((savefd = filemap[fd].save_fd) >= 0)
 		{
@@ -1885,7 +1929,7 @@ static int slowexcept(Sfio_t *iop,int type,void *data,Sfdisc_t *handle)
 #   endif /* O_NDELAY */
 #endif /* !FNDELAY */
 #ifdef O_NONBLOCK
-		if(errno==EAGAIN)
+		if(errno==EAGAIN && !(sh.fdstatus[fno]&IONBLOCK))
 		{
 			n = fcntl(fno,F_GETFL,0);
 			n &= ~O_NONBLOCK;
@@ -1954,6 +1998,8 @@ static ssize_t piperead(Sfio_t *iop,void *buff,size_t size,Sfdisc_t *handle)
 	}
 	if(sh_isstate(SH_INTERACTIVE) && fd==0 && io_prompt(iop,sh.nextprompt)<0 && errno==EIO)
 		return 0;
+	/* write out standard output that print left in the buffer before blocking */
+	sfsync(sfstdout);
 	sh_onstate(SH_TTYWAIT);
 	if(!(sh.fdstatus[fd]&IOCLEX) && (sfset(iop,0,0)&SFIO_SHARE))
 		size = ed_read(sh.ed_context, fd, (char*)buff, size,0);
@@ -1991,6 +2037,7 @@ static ssize_t slowread(Sfio_t *iop,void *buff,size_t size,Sfdisc_t *handle)
 		errno = EINTR;
 		return -1;
 	}
+	sfsync(sfstdout);
 	fno = sffileno(iop);
 #ifdef O_NONBLOCK
 	if((n=fcntl(fno,F_GETFL,0))!=-1 && n&O_NONBLOCK)
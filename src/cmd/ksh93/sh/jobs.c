@@ -75,7 +75,9 @@
  */
 struct jobsave
 {
-	struct jobsave	*next;
+	struct jobsave	*next;		/* next older entry */
+	struct jobsave	*prev;		/* next newer entry */
+	struct jobsave	*hnext;		/* next entry in hash chain */
 	pid_t		pid;
 	unsigned short	exitval;
 };
@@ -117,10 +119,21 @@ static void init_savelist(void)
 struct back_save
 {
 	int		count;
-	struct jobsave	*list;
+	struct jobsave	*list;		/* newest entry */
+	struct jobsave	*last;		/* oldest entry */
+	struct jobsave	**hash;		/* entries hashed by process ID */
+	int		hsize;		/* number of hash chains, a power of 2 */
 	struct back_save *prev;
 };
 
+/*
+ * Both the posted processes and the saved exit statuses are hashed by
+ * process ID so that reaping and waiting do not walk the whole list.
+ * The number of hash chains doubles when there are more entries.
+ */
+#define HASHMIN		64
+#define PIDHASH(pid,size)	((unsigned int)(pid)&((size)-1))
+
 #define BYTE(n)		(((n)+CHAR_BIT-1)/CHAR_BIT)
 #define MAXMSG	25
 #define SH_STOPSIG	(SH_EXITSIG<<1)
@@ -155,6 +168,7 @@ struct back_save
 #define P_BG		01000	/* set if the process is running in the background */
 
 static int		job_chksave(pid_t);
+static void		proc_hash(struct process*);
 static struct process	*job_bypid(pid_t);
 static struct process	*job_byjid(int);
 static char		*job_sigmsg(int);
@@ -171,6 +185,9 @@ static char		by_number;
 static Sfio_t		*outfile;
 static pid_t		lastpid;
 static struct back_save	bck;
+static struct process	**pidtab;	/* posted processes hashed by process ID */
+static int		pidtabsize;
+static int		pidcount;
 
 static void		job_set(struct process*);
 static void		job_reset(struct process*);
@@ -220,16 +237,69 @@ void job_chldtrap(int unpost)
 }
 #endif /* SHOPT_BGX */
 
+/*
+ * add <jp> as the newest entry of the saved exit statuses <bp>
+ */
+static void save_link(struct back_save *bp, struct jobsave *jp)
+{
+	struct jobsave **hp;
+	if(bp->count >= bp->hsize)
+	{
+		/* double the number of hash chains and rehash */
+		int n = bp->hsize ? 2*bp->hsize : HASHMIN;
+		struct jobsave *xp;
+		hp = sh_newof(NULL,struct jobsave*,n,0);
+		for(xp=bp->last; xp; xp=xp->prev)
+		{
+			xp->hnext = hp[PIDHASH(xp->pid,n)];
+			hp[PIDHASH(xp->pid,n)] = xp;
+		}
+		free(bp->hash);
+		bp->hash = hp;
+		bp->hsize = n;
+	}
+	hp = &bp->hash[PIDHASH(jp->pid,bp->hsize)];
+	jp->hnext = *hp;
+	*hp = jp;
+	jp->prev = 0;
+	if(jp->next = bp->list)
+		bp->list->prev = jp;
+	else
+		bp->last = jp;
+	bp->list = jp;
+	bp->count++;
+}
+
+/*
+ * remove <jp> from the saved exit statuses <bp>
+ */
+static void save_unlink(struct back_save *bp, struct jobsave *jp)
+{
+	struct jobsave **hp = &bp->hash[PIDHASH(jp->pid,bp->hsize)];
+	while(*hp != jp)
+		hp = &(*hp)->hnext;
+	*hp = jp->hnext;
+	if(jp->prev)
+		jp->prev->next = jp->next;
+	else
+		bp->list = jp->next;
+	if(jp->next)
+		jp->next->prev = jp->prev;
+	else
+		bp->last = jp->prev;
+	bp->count--;
+}
+
 /*
  * return next on link list of jobsave free list
  */
 static struct jobsave *jobsave_create(pid_t pid)
 {
-	struct jobsave *jp = job_savelist;
+	struct jobsave *jp;
 	job_chksave(pid);
-	if(++bck.count > sh.lim.child_max)
+	if(bck.count >= sh.lim.child_max)
 		job_chksave(0);
-	if(jp)
+	if(jp = job_savelist)
 	{
 		njob_savelist--;
 		job_savelist = jp->next;
@@ -239,9 +309,8 @@ static struct jobsave *jobsave_create(pid_t pid)
 	if(jp)
 	{
 		jp->pid = pid;
-		jp->next = bck.list;
-		bck.list = jp;
 		jp->exitval = 0;
+		save_link(&bck,jp);
 	}
 	return jp;
 }
@@ -1052,12 +1121,18 @@ void	job_clear(void)
 			free(px);
 		}
 	}
+	if(pidtab)
+		memset(pidtab,0,pidtabsize*sizeof(struct process*));
+	pidcount = 0;
 	for(jp=bck.list; jp;jp=jpnext)
 	{
 		jpnext = jp->next;
 		free(jp);
 	}
-	bck.list = 0;
+	free(bck.hash);
+	bck.list = bck.last = 0;
+	bck.hash = 0;
+	bck.hsize = bck.count = 0;
 	if(njob_savelist < NJOB_SAVELIST)
 		init_savelist();
 	job.pwlist = NULL;
@@ -1144,6 +1219,7 @@ int job_post(pid_t pid, pid_t join)
 	job.pwlist = pw;
 	pw->p_env = sh.curenv;
 	pw->p_pid = pid;
+	proc_hash(pw);
 	if(!sh.outpipe || sh.cpid==pid)
 		pw->p_flag = P_EXITSAVE;
 	pw->p_exitmin = sh.xargexit;
@@ -1197,17 +1273,75 @@ int job_post(pid_t pid, pid_t join)
 }
 
 /*
- * Returns a process structure give a process ID
+ * add posted process <pw> to the process ID hash table
  */
-static struct process *job_bypid(pid_t pid)
+static void proc_hash(struct process *pw)
 {
-	struct process  *pw, *px;
-	for(pw=job.pwlist; pw; pw=pw->p_nxtjob)
-		for(px=pw; px; px=px->p_nxtproc)
+	struct process **pp;
+	if(pidcount >= pidtabsize)
+	{
+		/* double the number of hash chains and split each chain in order */
+		int i, n = pidtabsize ? 2*pidtabsize : HASHMIN;
+		struct process *px, *pxnext, **lo, **hi;
+		pp = sh_newof(NULL,struct process*,n,0);
+		for(i=0; i < pidtabsize; i++)
 		{
-			if(px->p_pid==pid)
-				return px;
+			lo = &pp[i];
+			hi = &pp[i+pidtabsize];
+			for(px=pidtab[i]; px; px=pxnext)
+			{
+				pxnext = px->p_nxthash;
+				px->p_nxthash = 0;
+				if(PIDHASH(px->p_pid,n)==i)
+				{
+					*lo = px;
+					lo = &px->p_nxthash;
+				}
+				else
+				{
+					*hi = px;
+					hi = &px->p_nxthash;
+				}
+			}
 		}
+		free(pidtab);
+		pidtab = pp;
+		pidtabsize = n;
+	}
+	pp = &pidtab[PIDHASH(pw->p_pid,pidtabsize)];
+	pw->p_nxthash = *pp;
+	*pp = pw;
+	pidcount++;
+}
+
+/*
+ * remove posted process <pw> from the process ID hash table
+ */
+static void proc_unhash(struct process *pw)
+{
+	struct process **pp = &pidtab[PIDHASH(pw->p_pid,pidtabsize)];
+	while(*pp && *pp != pw)
+		pp = &(*pp)->p_nxthash;
+	if(*pp)
+	{
+		*pp = pw->p_nxthash;
+		pidcount--;
+	}
+}
+
+/*
+ * Returns a process structure give a process ID
+ */
+static struct process *job_bypid(pid_t pid)
+{
+	struct process  *px;
+	if(!pidtab)
+		return NULL;
+	for(px=pidtab[PIDHASH(pid,pidtabsize)]; px; px=px->p_nxthash)
+	{
+		if(px->p_pid==pid)
+			return px;
+	}
 	return NULL;
 }
 
@@ -1588,6 +1722,7 @@ static struct process *job_unpost(struct process *pwtop,int notify)
 		}
 		pw->p_flag &= ~P_DONE;
 		job.numpost--;
+		proc_unhash(pw);
 		pw->p_nxtjob = freelist;
 		freelist = pw;
 	}
@@ -1690,37 +1825,23 @@ static char *job_sigmsg(int sig)
  */
 static int job_chksave(pid_t pid)
 {
-	struct jobsave *jp = bck.list, *jpold=0;
-	int r= -1;
-	int count=bck.count;
 	struct back_save *bp= &bck;
-again:
-	while(jp && count-->0)
-	{
-		if(jp->pid==pid)
-			break;
-		if(pid==0 && !jp->next)
-			break;
-		jpold = jp;
-		jp = jp->next;
-	}
-	if(!jp && pid && (bp=bp->prev))
+	struct jobsave *jp = NULL;
+	int r= -1;
+	if(pid==0)
+		jp = bck.last;
+	else do
 	{
-		count = bp->count;
-		jp = bp->list;
-		jpold = 0;
-		goto again;
+		if(bp->hsize)
+			for(jp=bp->hash[PIDHASH(pid,bp->hsize)]; jp && jp->pid!=pid; jp=jp->hnext);
 	}
+	while(!jp && (bp=bp->prev));
 	if(jp)
 	{
 		r = 0;
 		if(pid)
 			r = jp->exitval;
-		if(jpold)
-			jpold->next = jp->next;
-		else
-			bp->list = jp->next;
-		bp->count--;
+		save_unlink(bp,jp);
 		if(njob_savelist < NJOB_SAVELIST)
 		{
 			njob_savelist++;
@@ -1740,7 +1861,9 @@ void *job_subsave(void)
 	*bp = bck;
 	bp->prev = bck.prev;
 	bck.count = 0;
-	bck.list = 0;
+	bck.list = bck.last = 0;
+	bck.hash = 0;
+	bck.hsize = 0;
 	bck.prev = bp;
 	job_unlock();
 	return bp;
@@ -1748,22 +1871,19 @@ void *job_subsave(void)
 
 void job_subrestore(void* ptr)
 {
-	struct jobsave *jp;
+	struct jobsave *jp, *jpnext;
 	struct back_save *bp = (struct back_save*)ptr;
 	struct process *pw, *px, *pwnext;
-	struct jobsave *end=NULL;
 	job_lock();
-	for(jp=bck.list; jp; jp=jp->next)
+	/* the exit statuses saved in the subshell are newer */
+	for(jp=bck.last; jp; jp=jpnext)
 	{
-		if (!jp->next)
-			end = jp;
+		jpnext = jp->prev;
+		save_unlink(&bck,jp);
+		save_link(bp,jp);
 	}
-	if(end)
-		end->next = bp->list;
-	else
-		bck.list = bp->list;
-	bck.count += bp->count;
-	bck.prev = bp->prev;
+	free(bck.hash);
+	bck = *bp;
 	while(bck.count > sh.lim.child_max)
 		job_chksave(0);
 	for(pw=job.pwlist; pw; pw=pwnext)
@@ -0,0 +1,724 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+/*
+ * JSON output and input for variables
+ *
+ * nv_outjson() writes a variable as JSON: compound variables and
+ * associative arrays become objects, indexed arrays become arrays,
+ * variables with a numeric attribute become numbers and all other
+ * values become strings.
+ *
+ * nv_readjson() parses one JSON value from a stream and assigns it
+ * to a variable while it is being read, so no text is built up for
+ * the whole value. Objects become compound variables, arrays become
+ * indexed arrays, and numbers get the -li or -lE attribute. An array
+ * gets a numeric attribute only if all its elements are numbers.
+ * Like read, it does not consume input past the line the value ends
+ * on when the input is shared with other processes and can't seek.
+ */
+
+#include	"shopt.h"
+#include	"defs.h"
+#include	<math.h>
+#include	<ast_float.h>
+#include	"name.h"
+#include	"lexstates.h"
+
+#define JSON_MAXDEPTH	1000	/* maximum nesting of objects and arrays */
+
+/* kinds of scalar values, used to pick the attributes of an array */
+#define JSON_INT	1
+#define JSON_FLOAT	2
+#define JSON_OTHER	4
+
+struct jsonread
+{
+	Sfio_t		*iop;		/* input stream */
+	Sfio_t		*path;		/* name of the variable being assigned */
+	Sfio_t		*buf;		/* string or number being read */
+	const char	*err;		/* syntax error message */
+	int		depth;
+	int		lines;		/* read iop a line at a time */
+	unsigned char	*cp;		/* next character of the current line */
+	unsigned char	*ep;		/* end of the current line */
+};
+
+static void	json_node(Sfio_t*, Namval_t*, int);
+static void	json_scalar(Sfio_t*, Namval_t*);
+static int	json_value(struct jsonread*, int, int*);
+
+/*
+ * write <s> as a JSON string
+ */
+static void json_string(Sfio_t *out, const char *s)
+{
+	const unsigned char	*cp = (const unsigned char*)s, *sp;
+	int			c;
+	sfputc(out,'"');
+	while(1)
+	{
+		for(sp=cp; (c = *cp) >= 0x20 && c!='"' && c!='\\'; cp++);
+		if(cp > sp)
+			sfwrite(out,sp,cp-sp);
+		if(c==0)
+			break;
+		cp++;
+		sfputc(out,'\\');
+		switch(c)
+		{
+		    case '"':
+		    case '\\':
+			sfputc(out,c);
+			break;
+		    case '\b':
+			sfputc(out,'b');
+			break;
+		    case '\f':
+			sfputc(out,'f');
+			break;
+		    case '\n':
+			sfputc(out,'n');
+			break;
+		    case '\r':
+			sfputc(out,'r');
+			break;
+		    case '\t':
+			sfputc(out,'t');
+			break;
+		    default:
+			sfprintf(out,"u%04x",c);
+			break;
+		}
+	}
+	sfputc(out,'"');
+}
+
+/*
+ * write the value of the numeric variable <np> as a JSON number
+ */
+static void json_number(Sfio_t *out, Namval_t *np)
+{
+	Sfdouble_t	d = nv_getnum(np);
+	char		buf[64], *cp;
+	if(nv_isattr(np,NV_DOUBLE)!=NV_DOUBLE)
+	{
+		if(nv_isattr(np,NV_UNSIGN))
+			sfprintf(out,"%llu",(Sfulong_t)d);
+		else
+			sfprintf(out,"%lld",(Sflong_t)d);
+		return;
+	}
+	if(!isfinite(d))
+	{
+		sfwrite(out,"null",4);
+		return;
+	}
+	sfsprintf(buf,sizeof(buf),"%.*Lg",nv_isattr(np,NV_LONG)?LDBL_DIG:nv_isattr(np,NV_SHORT)?FLT_DIG:DBL_DIG,d);
+	/* the radix character of the locale is not valid in JSON */
+	for(cp=buf; *cp; cp++)
+	{
+		if(!isdigit(*cp) && *cp!='-' && *cp!='+' && *cp!='e')
+			*cp = '.';
+	}
+	sfputr(out,buf,-1);
+}
+
+/*
+ * write the names and values of the members of compound variable <np>
+ */
+static void json_object(Sfio_t *out, Namval_t *np, int depth)
+{
+	char		*name, *cp;
+	void		*dir, *savptr = stkfreeze(sh.stk,0);
+	int		len, n=0, comma=0, savtop = stktell(sh.stk);
+	Namval_t	*mp;
+	Dt_t		*root;
+	name = stkcopy(sh.stk,nv_name(np));
+	len = strlen(name);
+	sh.last_root = 0;
+	dir = nv_diropen(name[len-1]==']'?np:NULL,name);
+	root = sh.last_root?sh.last_root:sh.var_tree;
+	/* collect the names of the members first as nv_open() can disturb the walk */
+	while(cp = nv_dirnext(dir))
+	{
+		if(cp[len]=='.' && !strpbrk(cp+len+1,".["))
+		{
+			sfputr(sh.stk,cp+len+1,0);
+			n++;
+		}
+	}
+	nv_dirclose(dir);
+	cp = stkfreeze(sh.stk,0);
+	sfputc(out,'{');
+	while(n-- > 0)
+	{
+		sfprintf(sh.strbuf,"%s.%s",name,cp);
+		if(mp = nv_open(sfstruse(sh.strbuf),root,NV_VARNAME|NV_NOADD|NV_NOFAIL))
+		{
+			if(comma)
+				sfputc(out,',');
+			json_string(out,cp);
+			sfputc(out,':');
+			json_node(out,mp,depth);
+			comma = 1;
+		}
+		cp += strlen(cp)+1;
+	}
+	sfputc(out,'}');
+	stkset(sh.stk,savptr,savtop);
+}
+
+/*
+ * write the elements of array <np> as a JSON array, or as an object
+ * if <np> is an associative array
+ */
+static void json_array(Sfio_t *out, Namval_t *np, Namarr_t *ap, int depth)
+{
+	Namval_t	*mp;
+	int		assoc = array_assoc(ap)!=0, scan, more;
+	sfputc(out,assoc?'{':'[');
+	if(array_elem(ap) && (ap->nelem&ARRAY_SCAN || nv_putsub(np,NULL,ARRAY_SCAN)))
+	{
+		do
+		{
+			if(assoc)
+			{
+				json_string(out,nv_getsub(np));
+				sfputc(out,':');
+			}
+			scan = ap->nelem&ARRAY_SCAN;
+			if(mp = nv_opensub(np))
+				json_node(out,mp,depth);
+			else
+				json_scalar(out,np);
+			ap->nelem |= scan;
+			if(more = nv_nextsub(np))
+				sfputc(out,',');
+		}
+		while(more);
+	}
+	sfputc(out,assoc?'}':']');
+}
+
+/*
+ * write the value of the scalar <np>
+ */
+static void json_scalar(Sfio_t *out, Namval_t *np)
+{
+	char	*cp;
+	if(nv_isattr(np,NV_INTEGER) && !nv_hasdisc(np,&ENUM_disc))
+		json_number(out,np);
+	else if(cp = nv_getval(np))
+		json_string(out,cp);
+	else
+		sfwrite(out,"null",4);
+}
+
+static void json_node(Sfio_t *out, Namval_t *np, int depth)
+{
+	Namarr_t	*ap;
+	if(++depth > JSON_MAXDEPTH)
+	{
+		errormsg(SH_DICT,ERROR_exit(1),"%s: too deeply nested for JSON",nv_name(np));
+		UNREACHABLE();
+	}
+	if(ap = nv_arrayptr(np))
+		json_array(out,np,ap,depth);
+	else if(nv_isarray(np))
+		sfwrite(out,"[]",2);
+	else if(nv_isvtree(np))
+		json_object(out,np,depth);
+	else
+		json_scalar(out,np);
+}
+
+/*
+ * write variable <np> as JSON to <out>
+ */
+int nv_outjson(Namval_t *np, Sfio_t *out)
+{
+	Dt_t	*last_root = sh.last_root;
+	json_node(out,np,0);
+	sh.last_root = last_root;
+	return sferror(out) ? -1 : 0;
+}
+
+/*
+ * return the next input character; in line mode, the input is read with
+ * sfgetr() so that no more than the current line is taken from a pipe
+ */
+static int json_getc(struct jsonread *jp)
+{
+	char	*sp;
+	if(!jp->lines)
+		return sfgetc(jp->iop);
+	if(jp->cp >= jp->ep)
+	{
+		if(!(sp = sfgetr(jp->iop,'\n',0)) && !(sp = sfgetr(jp->iop,'\n',-1)))
+			return EOF;
+		jp->cp = (unsigned char*)sp;
+		jp->ep = jp->cp + sfvalue(jp->iop);
+	}
+	return *jp->cp++;
+}
+
+static void json_ungetc(struct jsonread *jp, int c)
+{
+	if(c==EOF)
+		return;
+	if(jp->lines)
+		jp->cp--;
+	else
+		sfungetc(jp->iop,c);
+}
+
+/*
+ * return the next character that is not white space
+ */
+static int json_skip(struct jsonread *jp)
+{
+	int	c;
+	while((c = json_getc(jp))==' ' || c=='\n' || c=='\t' || c=='\r');
+	return c;
+}
+
+/*
+ * return the name of the variable to assign to
+ */
+static char *json_path(struct jsonread *jp)
+{
+	sfputc(jp->path,0);
+	sfstrseek(jp->path,-1,SEEK_CUR);
+	return sfstrbase(jp->path);
+}
+
+static int json_hex(struct jsonread *jp)
+{
+	int	c, n, w = 0;
+	for(n=0; n < 4; n++)
+	{
+		if((c = json_getc(jp)) >= '0' && c <= '9')
+			c -= '0';
+		else if(c >= 'a' && c <= 'f')
+			c -= 'a'-10;
+		else if(c >= 'A' && c <= 'F')
+			c -= 'A'-10;
+		else
+			return -1;
+		w = (w<<4) | c;
+	}
+	return w;
+}
+
+/*
+ * read the rest of a string into jp->buf and return it
+ */
+static char *json_str(struct jsonread *jp)
+{
+	int	c, w;
+	char	utf[8];
+	sfstrseek(jp->buf,0,SEEK_SET);
+	while((c = json_getc(jp))!='"')
+	{
+		if(c==0 || c==EOF)
+			goto bad;
+		if(c=='\\')
+		{
+			switch(c = json_getc(jp))
+			{
+			    case '"':
+			    case '\\':
+			    case '/':
+				break;
+			    case 'b':
+				c = '\b';
+				break;
+			    case 'f':
+				c = '\f';
+				break;
+			    case 'n':
+				c = '\n';
+				break;
+			    case 'r':
+				c = '\r';
+				break;
+			    case 't':
+				c = '\t';
+				break;
+			    case 'u':
+				if((c = json_hex(jp)) <= 0)
+					goto bad;
+				if(c >= 0xd800 && c < 0xdc00)
+				{
+					/* surrogate pair */
+					if(json_getc(jp)!='\\' || json_getc(jp)!='u' || (w = json_hex(jp)) < 0xdc00 || w >= 0xe000)
+						goto bad;
+					c = 0x10000 + ((c-0xd800)<<10) + (w-0xdc00);
+				}
+				else if(c >= 0xdc00 && c < 0xe000)
+					goto bad;
+				sfwrite(jp->buf,utf,wc2utf8(utf,c));
+				continue;
+			    default:
+				goto bad;
+			}
+		}
+		sfputc(jp->buf,c);
+	}
+	return sfstruse(jp->buf);
+bad:
+	jp->err = "invalid string";
+	return NULL;
+}
+
+/*
+ * read a number starting with <c> into jp->buf
+ * returns JSON_INT or JSON_FLOAT and sets *digits to the number of
+ * significant digits
+ */
+static int json_num(struct jsonread *jp, int c, int *digits)
+{
+	int	kind = JSON_INT, n = 0, lead = 1;
+	sfstrseek(jp->buf,0,SEEK_SET);
+	if(c=='-')
+	{
+		sfputc(jp->buf,c);
+		c = json_getc(jp);
+	}
+	if(!isdigit(c))
+		goto bad;
+	if(c=='0')
+	{
+		sfputc(jp->buf,c);
+		c = json_getc(jp);
+	}
+	else for(; isdigit(c); c = json_getc(jp))
+	{
+		sfputc(jp->buf,c);
+		n++;
+		lead = 0;
+	}
+	if(n > 18)
+		kind = JSON_FLOAT;
+	if(c=='.')
+	{
+		kind = JSON_FLOAT;
+		sfputc(jp->buf,c);
+		if(!isdigit(c = json_getc(jp)))
+			goto bad;
+		for(; isdigit(c); c = json_getc(jp))
+		{
+			sfputc(jp->buf,c);
+			if(lead && c=='0')
+				continue;
+			lead = 0;
+			n++;
+		}
+	}
+	if(c=='e' || c=='E')
+	{
+		kind = JSON_FLOAT;
+		sfputc(jp->buf,'e');
+		if((c = json_getc(jp))=='-' || c=='+')
+		{
+			sfputc(jp->buf,c);
+			c = json_getc(jp);
+		}
+		if(!isdigit(c))
+			goto bad;
+		for(; isdigit(c); c = json_getc(jp))
+			sfputc(jp->buf,c);
+	}
+	json_ungetc(jp,c);
+	*digits = n ? n : 1;
+	return kind;
+bad:
+	jp->err = "invalid number";
+	return 0;
+}
+
+/*
+ * read the rest of the literal true, false or null starting with <c>
+ * returns its value, which is empty for null, or NULL if it is invalid
+ */
+static char *json_literal(struct jsonread *jp, int c)
+{
+	const char	*word = c=='t' ? "rue" : c=='f' ? "alse" : "ull";
+	for(; *word; word++)
+	{
+		if(json_getc(jp)!=*word)
+		{
+			jp->err = "invalid literal";
+			return NULL;
+		}
+	}
+	return c=='t' ? "true" : c=='f' ? "false" : "";
+}
+
+/*
+ * give variable <np> the numeric attribute for <kind>
+ */
+static void json_numattr(Namval_t *np, int kind, int digits)
+{
+	if(kind==JSON_INT)
+		nv_newattr(np,NV_INT64,10);
+	else
+		nv_newattr(np,NV_LDOUBLE|NV_EXPNOTE,digits > LDBL_DIG ? LDBL_DIG : digits);
+}
+
+/*
+ * read the members of an object into the compound variable named jp->path
+ */
+static int json_object_read(struct jsonread *jp)
+{
+	Namval_t	*np;
+	Namarr_t	*ap;
+	char		*cp;
+	int		c, kind, top = sfstrtell(jp->path);
+	cp = json_path(jp);
+	if(cp[top-1]==']')
+	{
+		/* array element; make it a compound variable like typeset -C -a */
+		np = nv_open(cp,sh.var_tree,NV_VARNAME|NV_ASSIGN);
+		if((ap = nv_arrayptr(np)) && !nv_opensub(np))
+		{
+			ap->nelem |= ARRAY_TREE;
+			nv_putsub(np,NULL,ARRAY_ADD|nv_aindex(np));
+			ap->nelem &= ~ARRAY_TREE;
+		}
+	}
+	else
+	{
+		np = nv_open(cp,sh.var_tree,NV_VARNAME|NV_ARRAY|NV_ASSIGN);
+		if(!nv_isnull(np) || nv_isvtree(np) || nv_isarray(np))
+			nv_unset(np);
+		nv_setvtree(np);
+	}
+	if((c = json_skip(jp))=='}')
+		return 0;
+	while(1)
+	{
+		if(c!='"' || !(cp = json_str(jp)))
+			break;
+		if(isaletter(*cp))
+			while(*++cp && isaname(*cp));
+		if(*cp || cp==sfstrbase(jp->buf))
+		{
+			jp->err = "member name is not a valid variable name";
+			return -1;
+		}
+		sfputc(jp->path,'.');
+		sfputr(jp->path,sfstrbase(jp->buf),-1);
+		if(json_skip(jp)!=':')
+			break;
+		if(json_value(jp,json_skip(jp),&kind) < 0)
+			return -1;
+		sfstrseek(jp->path,top,SEEK_SET);
+		if((c = json_skip(jp))=='}')
+			return 0;
+		if(c!=',')
+			break;
+		c = json_skip(jp);
+	}
+	if(!jp->err)
+		jp->err = "invalid object";
+	return -1;
+}
+
+/*
+ * read the elements of an array into the indexed array named jp->path
+ */
+static int json_array_read(struct jsonread *jp)
+{
+	Namval_t	*np;
+	char		*cp;
+	int		c, n, sub, kind, kinds = 0, digits, maxdigits = 1, top = sfstrtell(jp->path);
+	cp = json_path(jp);
+	if(sub = cp[top-1]==']')
+	{
+		/* an array in an array; nv_open() returns the subarray of the multidimensional array */
+		np = nv_open(cp,sh.var_tree,NV_VARNAME|NV_ARRAY|NV_ASSIGN);
+	}
+	else
+	{
+		np = nv_open(cp,sh.var_tree,NV_VARNAME|NV_ASSIGN);
+		if(!nv_isnull(np) || nv_isvtree(np) || nv_isarray(np))
+			nv_unset(np);
+		nv_onattr(np,NV_ARRAY);
+	}
+	if((c = json_skip(jp))==']')
+		return 0;
+	for(n=0; ; n++)
+	{
+		if(c=='{' || c=='[')
+		{
+			/* nested value; assign it by name */
+			sfprintf(jp->path,"[%d]",n);
+			if(json_value(jp,c,&kind) < 0)
+				return -1;
+			sfstrseek(jp->path,top,SEEK_SET);
+		}
+		else if(c=='"')
+		{
+			if(!json_str(jp))
+				return -1;
+			nv_putsub(np,NULL,ARRAY_ADD|ARRAY_FILL|n);
+			nv_putval(np,sfstrbase(jp->buf),0);
+			kind = JSON_OTHER;
+		}
+		else if(c=='-' || isdigit(c))
+		{
+			if(!(kind = json_num(jp,c,&digits)))
+				return -1;
+			if(digits > maxdigits)
+				maxdigits = digits;
+			nv_putsub(np,NULL,ARRAY_ADD|ARRAY_FILL|n);
+			nv_putval(np,sfstruse(jp->buf),0);
+		}
+		else if(c=='t' || c=='f' || c=='n')
+		{
+			if(!(cp = json_literal(jp,c)))
+				return -1;
+			if(*cp)
+			{
+				nv_putsub(np,NULL,ARRAY_ADD|ARRAY_FILL|n);
+				nv_putval(np,cp,0);
+			}
+			kind = JSON_OTHER;
+		}
+		else
+		{
+			jp->err = c==EOF ? "unexpected end of file" : "invalid value";
+			return -1;
+		}
+		kinds |= kind;
+		if((c = json_skip(jp))==']')
+			break;
+		if(c!=',')
+		{
+			jp->err = "invalid array";
+			return -1;
+		}
+		c = json_skip(jp);
+	}
+	if(!sub && kinds && !(kinds&JSON_OTHER))
+		json_numattr(np,kinds==JSON_INT?JSON_INT:JSON_FLOAT,maxdigits);
+	return 0;
+}
+
+/*
+ * read the value starting with <c> and assign it to the variable
+ * named jp->path; *kind is set to the kind of value
+ */
+static int json_value(struct jsonread *jp, int c, int *kind)
+{
+	Namval_t	*np;
+	char		*cp;
+	int		digits, r;
+	*kind = JSON_OTHER;
+	switch(c)
+	{
+	    case '{':
+	    case '[':
+		if(++jp->depth > JSON_MAXDEPTH)
+		{
+			jp->err = "too deeply nested";
+			return -1;
+		}
+		r = c=='{' ? json_object_read(jp) : json_array_read(jp);
+		jp->depth--;
+		return r;
+	    case '"':
+		if(!(cp = json_str(jp)))
+			return -1;
+		break;
+	    case 't':
+	    case 'f':
+	    case 'n':
+		if(!(cp = json_literal(jp,c)))
+			return -1;
+		if(!*cp)
+			return 0;
+		break;
+	    default:
+		if(c=='-' || isdigit(c))
+		{
+			if(!(*kind = json_num(jp,c,&digits)))
+				return -1;
+			cp = sfstruse(jp->buf);
+			break;
+		}
+		jp->err = c==EOF ? "unexpected end of file" : "invalid value";
+		return -1;
+	}
+	np = nv_open(json_path(jp),sh.var_tree,NV_VARNAME|NV_ASSIGN);
+	if(nv_isattr(np,NV_INTEGER) && !nv_isarray(np))
+		nv_unset(np);
+	if(*kind!=JSON_OTHER && !nv_isarray(np))
+		json_numattr(np,*kind,digits);
+	nv_putval(np,cp,0);
+	return 0;
+}
+
+/*
+ * read one JSON value from <iop> and assign it to variable <name>
+ * returns 0 on success, 1 at end of file, and 2 for invalid input
+ */
+int nv_readjson(const char *name, Sfio_t *iop)
+{
+	static Sfio_t		*path, *buf;
+	struct jsonread		json;
+	Namval_t		*np, *mp;
+	Sfio_t			*sp;
+	char			*cp;
+	int			c, kind;
+	ssize_t			n;
+	memset(&json,0,sizeof(json));
+	json.iop = iop;
+	json.lines = (sfset(iop,0,0)&SFIO_SHARE) && sfseek(iop,(Sfoff_t)0,SEEK_CUR) < 0;
+	if((c = json_skip(&json))==EOF)
+		return 1;
+	if(!path)
+	{
+		path = sfstropen();
+		buf = sfstropen();
+	}
+	sfstrseek(path,0,SEEK_SET);
+	sfputr(path,name,-1);
+	np = nv_open(name,sh.var_tree,NV_VARNAME|NV_ASSIGN);
+	if(nv_isarray(np) && (mp = nv_opensub(np)))
+		np = mp;
+	nv_unset(np);
+	json.path = path;
+	json.buf = buf;
+	if(json_value(&json,c,&kind) < 0)
+	{
+		errormsg(SH_DICT,2,"%s: %s in JSON input",name,json.err);
+		return 2;
+	}
+	/* skip the end of the line so that the next read starts after it */
+	while((c = json_getc(&json))==' ' || c=='\t' || c=='\r');
+	if(c!='\n')
+		json_ungetc(&json,c);
+	if(json.lines && (n = json.ep - json.cp) > 0)
+	{
+		/* push back the rest of the line for the next read */
+		cp = sh_malloc(n);
+		memcpy(cp,json.cp,n);
+		if(sp = sfnew(NULL,cp,n,-1,SFIO_STRING|SFIO_READ|SFIO_MALLOC))
+			sfstack(iop,sp);
+		else
+			free(cp);
+	}
+	return 0;
+}
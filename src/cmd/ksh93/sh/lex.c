@@ -29,6 +29,7 @@
 #include	<ast.h>
 #include	<fcin.h>
 #include	<nval.h>
+#define MEM_TAG	MEM_PARSE
 #include	"defs.h"
 #include	"argnod.h"
 #include	"test.h"
@@ -196,6 +197,31 @@ static int lexfill(Lex_t *lp)
 	return c;
 }
 
+/*
+ * Return the length of the variable name starting at <first>
+ * The name ends before the current character <c>; the + of += is not counted
+ * After a buffer refill, lex_advance() has moved the start of the word to the stack
+ */
+static int varnamelen(Lex_t *lp, const char *first, int c)
+{
+	char	*cp = fcseek(0) - LEN;
+	int	n, instk = !lp->lexd.dolparen && !lp->lexd.first;
+	if(instk)
+		n = stktell(sh.stk) - ARGVAL + (cp - fcfirst());
+	else
+		n = cp - first;
+	if(c=='=' && n>0)
+	{
+		if(instk && cp==fcfirst())
+			c = *stkptr(sh.stk,stktell(sh.stk)-1);
+		else
+			c = cp[-1];
+		if(c=='+')
+			n--;	/* += */
+	}
+	return n;
+}
+
 /*
  * mode=1 for reinitialization
  */
@@ -1127,9 +1153,7 @@ int sh_lex(Lex_t* lp)
 			case S_EQ:
 				if(varnamefirst && !varnamelength)
 				{
-					varnamelength = fcseek(0) - LEN - varnamefirst;
-					if(varnamelength > 0 && fcpeek(-LEN - 1) == '+')
-						varnamelength--;  /* += */
+					varnamelength = varnamelen(lp,varnamefirst,c);
 				}
 				assignment = lp->assignok;
 				/* FALLTHROUGH */
@@ -1146,7 +1170,7 @@ int sh_lex(Lex_t* lp)
 				break;
 			case S_BRACT:
 				if(varnamefirst && !varnamelength && fcpeek(-LEN - 1)!='.')
-					varnamelength = fcseek(0) - LEN - varnamefirst;
+					varnamelength = varnamelen(lp,varnamefirst,c);
 				/* check for possible subscript */
 				if((n=endchar(lp))==RBRACT || n==RPAREN ||
 					(mode==ST_BRACE) ||
@@ -1804,9 +1804,18 @@ retry1:
 				v = 0;
 			else if(mbwide())
 			{
-				mbinit();
-				for(c = sliceoffset; c; c--)
-					mbchar(v);
+#if SHOPT_MULTIBYTE
+				ssize_t	len;
+				size_t	nc;
+				if(mbutf8() && (len = sh_utf8scan(v,strlen(v),sliceoffset,&nc)) >= 0 && nc == (size_t)sliceoffset)
+					v += len;
+				else
+#endif /* SHOPT_MULTIBYTE */
+				{
+					mbinit();
+					for(c = sliceoffset; c; c--)
+						mbchar(v);
+				}
 				c = ':';
 			}
 			else
@@ -1836,12 +1845,21 @@ retry1:
 				if(mbwide())
 				{
 					char *vp = v;
-					mbinit();
-					while(slicelength-- > 0)
+#if SHOPT_MULTIBYTE
+					ssize_t	len;
+					size_t	nc;
+					if(mbutf8() && (len = sh_utf8scan(v,vsize,slicelength,&nc)) >= 0 && nc == (size_t)slicelength)
+						vp += len;
+					else
+#endif /* SHOPT_MULTIBYTE */
 					{
-						if((c=mbsize(vp))<1)
-							c = 1;
-						vp += c;
+						mbinit();
+						while(slicelength-- > 0)
+						{
+							if((c=mbsize(vp))<1)
+								c = 1;
+							vp += c;
+						}
 					}
 					slicelength = vp - v;
 					c = ':';
@@ -2625,7 +2643,7 @@ static void endfield(Mac_t *mp,int split)
 static int substring(const char *string,size_t len,const char *pat,int match[], int flag)
 {
 	const char *sp=string;
-	int size,nmatch,n;
+	int size,nmatch,n,utf8=0;
 	int smatch[2*(MATCH_MAX+1)];
 	if(flag)
 	{
@@ -2638,9 +2656,22 @@ static int substring(const char *string,size_t len,const char *pat,int match[],
 	}
 	size = (int)len;
 	sp += size;
+#if SHOPT_MULTIBYTE
+	if(mbwide() && mbutf8())
+	{
+		/* in valid UTF-8, every byte that is not a continuation byte starts a character */
+		size_t nc;
+		utf8 = sh_utf8scan(string,len,len,&nc) == (ssize_t)len;
+	}
+#endif /* SHOPT_MULTIBYTE */
 	while(sp>=string)
 	{
-		if(mbwide())
+		if(utf8)
+		{
+			while(sp>string && (*(unsigned char*)sp & 0xc0) == 0x80)
+				sp--;
+		}
+		else if(mbwide())
 			sp = lastchar(string,sp);
 		if(n=strgrpmatch(sp,pat,(ssize_t*)smatch,elementsof(smatch)/2,STR_RIGHT|STR_LEFT|STR_MAXIMAL|STR_INT))
 		{
@@ -2687,6 +2718,14 @@ static int	charlen(const char *string,int len)
 	{
 		const char *str = string, *strmax=string+len;
 		int n=0;
+#if SHOPT_MULTIBYTE
+		if(mbutf8())
+		{
+			size_t	size = len>0 ? (size_t)len : strlen(string), nc;
+			if(sh_utf8scan(string,size,size,&nc) >= 0)
+				return (int)nc;
+		}
+#endif /* SHOPT_MULTIBYTE */
 		mbinit();
 		if(len>0)
 		{
@@ -2813,7 +2852,7 @@ static char *sh_tilde(const char *string)
 skip:
 #endif /* _WINIX */
 	if(!logins_tree)
-		logins_tree = dtopen(&_Nvdisc,Dtbag);
+		logins_tree = dtopen(&_Nvdisc,Dtpbag);
 	if(np=nv_search(string,logins_tree,NV_ADD))
 	{
 		save = sh.subshell;
@@ -201,6 +201,7 @@ int sh_main(int ac, char *av[], Shinit_f userinit)
 		sh.st.cmdname = error_info.id = command;
 		sh.sigflag[SIGTSTP] &= ~(SH_SIGIGNORE);
 		sh_offstate(SH_PROFILE);
+		sh_stats_startup(STAT_STPROFILE);
 		if(rshflag)
 			sh_onoption(SH_RESTRICTED);
 		/* open input file if specified */
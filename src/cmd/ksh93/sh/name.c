@@ -24,6 +24,7 @@
 #define putenv	___putenv
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include	"defs.h"
 #include	"variables.h"
 #include	"path.h"
@@ -2248,6 +2249,14 @@ int nv_scan(Dt_t *root, void (*fn)(Namval_t*,void*), void *data,int mask, int fl
 	return sdata.scancount;
 }
 
+/*
+ * Empty scope dictionaries are kept for reuse by sh_scope() so that
+ * function calls do not need to open and close one each time.
+ */
+#define SCOPEPOOL	16
+static Dt_t	*scopepool[SCOPEPOOL];
+static int	nscopepool;
+
 /*
  * create a new environment scope
  */
@@ -2259,7 +2268,10 @@ void sh_scope(struct argnod *envlist, int fun)
 	if(sh.namespace)
 		newroot = nv_dict(sh.namespace);
 #endif /* SHOPT_NAMESPACE */
-	newscope = dtopen(&_Nvdisc,Dtoset);
+	if(nscopepool)
+		newscope = scopepool[--nscopepool];
+	else
+		newscope = dtopen(&_Nvdisc,Dtoset);
 	if(envlist)
 	{
 		dtview(newscope,(Dt_t*)sh.var_tree);
@@ -3429,7 +3441,10 @@ void sh_unscope(void)
 			sh.st.real_fun->sdict->view = dp;
 		}
 		sh.var_tree=dp;
-		dtclose(root);
+		if(nscopepool<SCOPEPOOL && dtsize(root)==0)
+			scopepool[nscopepool++] = root;
+		else
+			dtclose(root);
 	}
 }
 
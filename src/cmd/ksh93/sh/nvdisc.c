@@ -22,6 +22,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include        "defs.h"
 #include        "variables.h"
 #include        "builtins.h"
@@ -25,6 +25,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include	"defs.h"
 #include	"name.h"
 #include	"argnod.h"
@@ -21,6 +21,7 @@
  *
  */
 #include	"shopt.h"
+#define MEM_TAG	MEM_VARS
 #include        "defs.h"
 #include        "io.h"
 #include        "variables.h"
@@ -349,7 +350,7 @@ static Namfun_t *clone_type(Namval_t* np, Namval_t *mp, int flags, Namfun_t *fp)
 	int			i;
 	Namval_t		*nq, *nr;
 	size_t			size = fp->dsize;
-	int			save, offset=stktell(sh.stk);
+	int			save, offset=stktell(sh.stk), prefix=0, end;
 	char			*cp;
 	Dt_t			*root = sh.last_root;
 	Namval_t		*last_table = sh.last_table;
@@ -394,18 +395,28 @@ static Namfun_t *clone_type(Namval_t* np, Namval_t *mp, int flags, Namfun_t *fp)
 			if(!mp->nvname)
 				continue;
 			sh.last_table = last_table;
-			if(pp->strsize<0)
-				cp = nv_name(np);
+			/* the instance name is the same for each member, so only generate it once */
+			if(prefix)
+				stkseek(sh.stk,prefix);
 			else
-				cp = nv_name(mp);
-			sfputr(sh.stk,cp,'.');
+			{
+				if(pp->strsize<0)
+					cp = nv_name(np);
+				else
+					cp = nv_name(mp);
+				sfputr(sh.stk,cp,'.');
+				prefix = stktell(sh.stk);
+			}
 			sfputr(sh.stk,nq->nvname,0);
+			end = stktell(sh.stk);
 			root = nv_dict(mp);
 			save = fp->nofree;
 			fp->nofree = 1;
 			nr = nv_create(stkptr(sh.stk,offset),root,NV_VARNAME|NV_NOADD,fp);
 			fp->nofree = save;
-			stkseek(sh.stk,offset);
+			if(nr || stktell(sh.stk)<end)
+				prefix = 0;
+			stkseek(sh.stk,prefix?prefix:offset);
 			if(nr)
 			{
 				if(nv_isattr(nq,NV_RDONLY) && (nq->nvalue || nv_isattr(nq,NV_INTEGER)))
@@ -460,6 +471,7 @@ static Namfun_t *clone_type(Namval_t* np, Namval_t *mp, int flags, Namfun_t *fp)
 			}
 		}
 	}
+	stkseek(sh.stk,offset);
 	if(nv_isattr(mp,NV_BINARY))
 		mp->nvalue = dp->data;
 	if(pp->strsize<0)
@@ -27,6 +27,7 @@
  */
 
 #include	"shopt.h"
+#define MEM_TAG	MEM_PARSE
 #include	"defs.h"
 #include	<fcin.h>
 #include	<error.h>
@@ -725,6 +726,68 @@ static struct regnod*	syncase(Lex_t *lexp,int esym)
 	return r;
 }
 
+/*
+ * Build a hash index for the arms of a case statement that consist only of
+ * literal patterns, so that a large dispatch table can be searched in
+ * constant time. Returns NULL if there are too few literals to bother.
+ * The index is allocated on the current stack along with the parse tree.
+ */
+struct swhash *sh_swhash(struct regnod *reg)
+{
+	struct regnod	*r;
+	struct argnod	*ap;
+	struct swhash	*hp;
+	struct swent	*ep;
+	unsigned int	size = 1;
+	int		nlit = 0, nslow = 0, n;
+	for(r=reg; r; r=r->regnxt)
+	{
+		for(n=0, ap=r->regptr; ap; ap=ap->argnxt.ap, n++)
+			if(!(ap->argflag&ARG_RAW))
+				break;
+		if(ap)
+			nslow++;
+		else
+			nlit += n;
+	}
+	if(nlit < SWHASH_MIN)
+		return NULL;
+	while(size < 2*(unsigned int)nlit)
+		size <<= 1;
+	hp = stkalloc(sh.stk,sizeof(struct swhash)+(size-1)*sizeof(struct swent)+nslow*sizeof(struct swent));
+	memset(hp->swbucket,0,size*sizeof(struct swent));
+	hp->swmask = size-1;
+	hp->swnslow = 0;
+	hp->swslow = &hp->swbucket[size];
+	for(n=0, r=reg; r; r=r->regnxt, n++)
+	{
+		for(ap=r->regptr; ap; ap=ap->argnxt.ap)
+			if(!(ap->argflag&ARG_RAW))
+				break;
+		if(ap)
+		{
+			ep = &hp->swslow[hp->swnslow++];
+			ep->swkey = 0;
+			ep->swreg = r;
+			ep->swnum = n;
+			continue;
+		}
+		for(ap=r->regptr; ap; ap=ap->argnxt.ap)
+		{
+			/* linear probing; keep the first arm to define a literal */
+			for(ep=&hp->swbucket[strhash(ap->argval)&hp->swmask]; ep->swkey; ep=&hp->swbucket[(ep-hp->swbucket+1)&hp->swmask])
+				if(strcmp(ep->swkey,ap->argval)==0)
+					break;
+			if(ep->swkey)
+				continue;
+			ep->swkey = ap->argval;
+			ep->swreg = r;
+			ep->swnum = n;
+		}
+	}
+	return hp;
+}
+
 /*
  * This routine creates the parse tree for the arithmetic for
  * When called, shlex.arg contains the string inside ((...))
@@ -870,7 +933,7 @@ static Shnode_t *funct(Lex_t *lexp)
 			{
 				struct Ufunction *rp;
 				Namval_t *np= nv_open(t->funct.functnam,sh.fun_tree,NV_ADD|NV_VARNAME);
-				rp = np->nvalue = new_of(struct Ufunction,sh.funload?sizeof(Dtlink_t):0);
+				rp = np->nvalue = sh_mallocx(sizeof(struct Ufunction)+(sh.funload?sizeof(Dtlink_t):0),MEM_FUNCS);
 				memset(rp, 0, sizeof(struct Ufunction));
 				rp->argc = ac->comarg.dp->dolnum;
 			}
@@ -1237,6 +1300,7 @@ static Shnode_t	*item(Lex_t *lexp,int flag)
 			lexp->lastline = saveline;
 			sh_syntax(lexp,0);
 		}
+		t->sw.swhash = sh_swhash(t->sw.swlst);
 		break;
 	    }
 
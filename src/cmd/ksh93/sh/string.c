@@ -28,6 +28,7 @@
 #include	"shtable.h"
 #include	"lexstates.h"
 #include	"national.h"
+#include	"FEATURE/hashtab"
 
 #if _hdr_wctype
 #   include <wctype.h>
@@ -37,20 +38,41 @@
 #   define iswprint(c)		(((c)&~0377) || isprint(c))
 #endif
 
+static const Shtable_t	empty = {0,0};
+
+/*
+ *  Lookup in a table with a perfect hash index generated by features/hashtab.sh
+ */
+static const Shtable_t *sh_hashlocate(const char *sp,const Shtable_t *table,const unsigned char *index,unsigned int seed,unsigned int mask)
+{
+	const unsigned char	*cp = (const unsigned char*)sp;
+	unsigned int		h = seed;
+	int			n;
+	while(*cp)
+		h = (h*33 + *cp++) % 65521;
+	if((n = index[h&mask]) && strcmp(sp,table[--n].sh_name)==0)
+		return &table[n];
+	return &empty;
+}
+
 /*
  *  Table lookup routine
  *  <table> is searched for string <sp> and corresponding value is returned
  *  This is only used for small tables and is used to save non-shareable memory
  *  NOTE: assumes tables are sorted by sh_name in ASCII order!
+ *  The reserved word and test operator tables are looked up by perfect hash.
  */
 const Shtable_t *sh_locate(const char *sp,const Shtable_t *table,int size)
 {
 	int			first;
 	const Shtable_t		*tp;
 	int			c;
-	static const Shtable_t	empty = {0,0};
 	if(sp==0 || (first= *sp)==0)
 		return &empty;
+	if(table==shtab_reserved)
+		return sh_hashlocate(sp,table,shtab_reserved_index,shtab_reserved_seed,shtab_reserved_mask);
+	if(table==shtab_testops)
+		return sh_hashlocate(sp,table,shtab_testops_index,shtab_testops_seed,shtab_testops_mask);
 	tp=table;
 	while((c = *tp->sh_name) && c <= first)
 	{
@@ -686,6 +708,100 @@ int sh_strchr(const char *string, const char *dp)
 	return cp ? cp-string : -1;
 }
 
+#if SHOPT_MULTIBYTE
+uint32_t	_sh_utf8serial;
+int		_sh_utf8;
+
+/*
+ * Find out if the current locale is UTF-8 for mbutf8() in national.h.
+ * The answer is valid until libast's setlocale() is called again.
+ */
+int sh_utf8init(void)
+{
+	_sh_utf8serial = ast.locale.serial;
+	return _sh_utf8 = mbwide() && (lcinfo(LC_CTYPE)->lc->flags&LC_utf8);
+}
+
+/* bytes with all bits set to 0x01 and 0x80 in a machine word */
+#define WORD_ONES	((size_t)-1 / 0xff)
+#define WORD_HIGHS	(WORD_ONES * 0x80)
+/* nonzero if the word w contains a byte that is null or not ASCII */
+#define WORD_NONASCII(w)	(((w) | ((w) - WORD_ONES)) & WORD_HIGHS)
+
+/*
+ * Return the length of the initial part of the n bytes at s that consists
+ * of non-null ASCII characters. The bytes are tested a machine word at a
+ * time and four words per iteration, which compilers can vectorize.
+ */
+size_t sh_asciilen(const char *s, size_t n)
+{
+	const unsigned char	*cp = (const unsigned char*)s, *ep = cp + n;
+	size_t			w[4];
+	while(ep - cp >= (ptrdiff_t)sizeof(w))
+	{
+		memcpy(w, cp, sizeof(w));
+		if(WORD_NONASCII(w[0]) | WORD_NONASCII(w[1]) | WORD_NONASCII(w[2]) | WORD_NONASCII(w[3]))
+			break;
+		cp += sizeof(w);
+	}
+	while(ep - cp >= (ptrdiff_t)sizeof(w[0]))
+	{
+		memcpy(w, cp, sizeof(w[0]));
+		if(WORD_NONASCII(w[0]))
+			break;
+		cp += sizeof(w[0]);
+	}
+	while(cp < ep && *cp && *cp < 0x80)
+		cp++;
+	return cp - (const unsigned char*)s;
+}
+
+/*
+ * Scan at most n bytes and max characters of the UTF-8 string s, stopping
+ * at a null byte. Return the number of bytes scanned and set *nchars to the
+ * number of characters, or return -1 if s contains an invalid or incomplete
+ * sequence; the caller then falls back to mbchar(), which deals with those.
+ * This accepts the same sequences of up to four bytes as libast's UTF-8
+ * decoder. The caller must make sure that mbutf8() is true.
+ */
+ssize_t sh_utf8scan(const char *s, size_t n, size_t max, size_t *nchars)
+{
+	static const uint32_t	minval[] = { 0, 0, 0x80, 0x800, 0x10000 };
+	const unsigned char	*cp = (const unsigned char*)s, *ep = cp + n;
+	size_t			nc = 0, k;
+	uint32_t		w;
+	int			c, m;
+	while(cp < ep && nc < max)
+	{
+		if(!((c = *cp) & 0x80))
+		{
+			/* run of ASCII characters */
+			if(!(k = sh_asciilen((char*)cp, ep - cp < max - nc ? ep - cp : max - nc)))
+				break;
+			cp += k;
+			nc += k;
+			continue;
+		}
+		m = c < 0xc0 ? 0 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : c < 0xf8 ? 4 : 0;
+		if(!m || ep - cp < m)
+			return -1;
+		w = c & (0x7f >> m);
+		for(k = 1; k < m; k++)
+		{
+			if((cp[k] & 0xc0) != 0x80)
+				return -1;
+			w = (w << 6) | (cp[k] & 0x3f);
+		}
+		if(w < minval[m] || w >= 0xd800 && (w <= 0xdfff || w >= 0xfffe && w <= 0xffff))
+			return -1;
+		cp += m;
+		nc++;
+	}
+	*nchars = nc;
+	return cp - (const unsigned char*)s;
+}
+#endif /* SHOPT_MULTIBYTE */
+
 const char *_sh_translate(const char *message)
 {
 	return ERROR_translate(0,0,e_dict,message);
@@ -392,7 +392,7 @@ Dt_t *sh_subtracktree(int create)
 	{
 		if(sp && !sp->strack)
 		{
-			sp->strack = dtopen(&_Nvdisc,Dtset);
+			sp->strack = dtopen(&_Nvdisc,Dtpset);
 			dtview(sp->strack,sh.track_tree);
 			sh.track_tree = sp->strack;
 		}
@@ -0,0 +1,270 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+/*
+ * Execution trace ring buffer for the tracebuf built-in
+ *
+ * While tracing is on, sh_exec(), sh_funct() and sh_funscope() call
+ * sh_trevent() to record fixed-size binary events: the start and end of
+ * each simple command and each function call. Nothing is formatted while recording;
+ * the oldest events are overwritten when the buffer is full.
+ *
+ * sh_trwrite() writes the buffer in binary form, oldest event first,
+ * after a header that lets sh_trprint() check the format and convert
+ * the monotonic timestamps to the time of day. sh_trprint() decodes
+ * the buffer or such a file into a timeline.
+ */
+
+#include	"shopt.h"
+#include	"defs.h"
+#include	<tm.h>
+#include	<tv.h>
+
+#define TR_MAGIC	"ksh\0trc1"
+#define TR_ORDER	0x01020304
+#define TR_MAXDEPTH	64	/* nesting tracked by sh_trprint() */
+
+typedef struct Trevent
+{
+	int64_t		time;		/* monotonic time in nanoseconds */
+	int32_t		pid;		/* process that recorded the event */
+	int32_t		line;		/* line number */
+	int32_t		status;		/* exit status for TR_END and TR_RETURN */
+	uint16_t	type;		/* TR_* from defs.h */
+	uint16_t	depth;		/* function nesting depth */
+	char		name[40];	/* command or function name, truncated */
+} Trevent_t;
+
+typedef struct Trhead
+{
+	char		magic[8];
+	uint32_t	order;		/* TR_ORDER in the writer's byte order */
+	uint32_t	size;		/* sizeof(Trevent_t) */
+	uint64_t	count;		/* number of events that follow */
+	uint64_t	lost;		/* events overwritten before writing */
+	int64_t		mono;		/* monotonic time of writing */
+	int64_t		real;		/* time of day of writing, in nanoseconds */
+} Trhead_t;
+
+typedef struct Trbuf
+{
+	size_t		size;		/* number of event slots */
+	size_t		next;		/* slot for the next event */
+	uint64_t	count;		/* events recorded since last cleared */
+	Trevent_t	ev[1];
+} Trbuf_t;
+
+static const char *trnames[] = { 0, "start", "end", "call", "return" };
+
+static int64_t trtime(void)
+{
+	Tv_t		tv;
+#ifdef CLOCK_MONOTONIC
+	struct timespec	ts;
+	if(clock_gettime(CLOCK_MONOTONIC,&ts)==0)
+		return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#endif
+	tvgettime(&tv);
+	return (int64_t)tv.tv_sec*1000000000 + tv.tv_nsec;
+}
+
+/*
+ * record an event; only called when sh.tracebuf is set
+ */
+void sh_trevent(int type, const char *name, int line, int status)
+{
+	Trbuf_t		*bp = (Trbuf_t*)sh.tracebuf;
+	Trevent_t	*ep = &bp->ev[bp->next];
+	if(++bp->next >= bp->size)
+		bp->next = 0;
+	bp->count++;
+	ep->time = trtime();
+	ep->pid = (int32_t)sh.current_pid;
+	ep->line = line;
+	ep->status = status;
+	ep->type = type;
+	ep->depth = sh.fn_depth;
+	strlcpy(ep->name, name ? name : "", sizeof(ep->name));
+}
+
+/*
+ * keep the last <count> events from now on; 0 stops tracing
+ * recorded events are discarded unless <count> is the current size
+ */
+void sh_trsize(size_t count)
+{
+	Trbuf_t	*bp = (Trbuf_t*)sh.tracebuf;
+	if(bp && bp->size==count)
+		return;
+	free(bp);
+	sh.tracebuf = 0;
+	if(count)
+	{
+		bp = sh_malloc(sizeof(Trbuf_t) + (count-1)*sizeof(Trevent_t));
+		bp->size = count;
+		bp->next = 0;
+		bp->count = 0;
+		sh.tracebuf = bp;
+	}
+}
+
+void sh_trclear(void)
+{
+	Trbuf_t	*bp = (Trbuf_t*)sh.tracebuf;
+	if(bp)
+		bp->next = bp->count = 0;
+}
+
+/*
+ * fill in <hp> and return a pointer to the oldest of the buffered events
+ * if the buffer wrapped around, the events from the start of the buffer
+ * are at ev[0] of the buffer and the number of those is put in <wrap>
+ */
+static Trevent_t *trhead(Trhead_t *hp, size_t *wrap)
+{
+	Trbuf_t	*bp = (Trbuf_t*)sh.tracebuf;
+	Tv_t	tv;
+	memset(hp,0,sizeof(*hp));
+	memcpy(hp->magic,TR_MAGIC,sizeof(hp->magic));
+	hp->order = TR_ORDER;
+	hp->size = sizeof(Trevent_t);
+	hp->mono = trtime();
+	tvgettime(&tv);
+	hp->real = (int64_t)tv.tv_sec*1000000000 + tv.tv_nsec;
+	*wrap = 0;
+	if(!bp)
+		return NULL;
+	if(bp->count > bp->size)
+	{
+		hp->count = bp->size;
+		hp->lost = bp->count - bp->size;
+		*wrap = bp->next;
+		return &bp->ev[bp->next];
+	}
+	hp->count = bp->count;
+	return &bp->ev[0];
+}
+
+/*
+ * write the buffered events in binary form to <out>
+ */
+int sh_trwrite(Sfio_t *out)
+{
+	Trhead_t	head;
+	size_t		wrap;
+	Trevent_t	*ep = trhead(&head,&wrap);
+	size_t		n = head.count - wrap;
+	if(sfwrite(out,&head,sizeof(head))!=sizeof(head))
+		return -1;
+	if(n && sfwrite(out,ep,n*sizeof(Trevent_t))!=n*sizeof(Trevent_t))
+		return -1;
+	if(wrap && sfwrite(out,((Trbuf_t*)sh.tracebuf)->ev,wrap*sizeof(Trevent_t))!=wrap*sizeof(Trevent_t))
+		return -1;
+	return 0;
+}
+
+/*
+ * write one event of the timeline to <out>; <sp> is the stack of
+ * start and call events used to compute the elapsed times
+ */
+static void trline(Sfio_t *out, const Trhead_t *hp, const Trevent_t *ep, Trevent_t *sp, int *np)
+{
+	int64_t		t = hp->real - (hp->mono - ep->time);
+	int		n = *np;
+	sfprintf(out,"%s.%06d [%d] %d: %*s%s %.*s", fmttime("%Y-%m-%d+%H:%M:%S",(time_t)(t/1000000000)),
+		(int)(t%1000000000/1000), ep->pid, ep->line, 2*ep->depth, "",
+		ep->type < elementsof(trnames) && trnames[ep->type] ? trnames[ep->type] : "?",
+		(int)sizeof(ep->name), ep->name);
+	switch(ep->type)
+	{
+	    case TR_START:
+	    case TR_CALL:
+		if(n == TR_MAXDEPTH)
+		{
+			memmove(sp, sp+1, (n-1)*sizeof(Trevent_t));
+			n--;
+		}
+		sp[n++] = *ep;
+		break;
+	    case TR_END:
+	    case TR_RETURN:
+		sfprintf(out," (status %d", ep->status);
+		/* find the matching start or call, skipping any that never ended */
+		while(n-- > 0)
+		{
+			if(sp[n].type==ep->type-1 && sp[n].depth==ep->depth && sp[n].pid==ep->pid
+			&& strncmp(sp[n].name,ep->name,sizeof(ep->name))==0)
+			{
+				sfprintf(out,", %.6fs", (double)(ep->time - sp[n].time) / 1e9);
+				break;
+			}
+		}
+		if(n < 0)
+			n = 0;
+		sfputc(out,')');
+		break;
+	}
+	sfputc(out,'\n');
+	*np = n;
+}
+
+/*
+ * write the timeline of the events in <in>, written by sh_trwrite(), to <out>
+ * if <in> is NULL, the events in the buffer are used
+ * returns -1 if <in> is not a tracebuf file, -2 if it is in a foreign
+ * format and -3 if it is truncated
+ */
+int sh_trprint(Sfio_t *in, Sfio_t *out)
+{
+	Trhead_t	head;
+	Trevent_t	*ep, *stack;
+	Sfoff_t		size;
+	size_t		i, wrap = 0;
+	int		depth = 0;
+	if(in)
+	{
+		if(sfread(in,&head,sizeof(head))!=sizeof(head) || memcmp(head.magic,TR_MAGIC,sizeof(head.magic)))
+			return -1;
+		if(head.order!=TR_ORDER || head.size!=sizeof(Trevent_t))
+			return -2;
+		/* check a regular file before printing any of it */
+		if((size = sfsize(in)) >= 0 && (Sfulong_t)size < sizeof(head) + head.count*sizeof(Trevent_t))
+			return -3;
+		ep = NULL;
+	}
+	else
+		ep = trhead(&head,&wrap);
+	stack = sh_malloc(TR_MAXDEPTH*sizeof(Trevent_t));
+	if(head.lost)
+		sfprintf(out,"# %llu earlier events were overwritten\n", (Sfulong_t)head.lost);
+	for(i=0; i < head.count; i++)
+	{
+		Trevent_t	ev;
+		if(in)
+		{
+			if(sfread(in,&ev,sizeof(ev))!=sizeof(ev))
+			{
+				free(stack);
+				return -3;
+			}
+		}
+		else
+		{
+			ev = *ep++;
+			if(i+wrap+1==head.count)
+				ep = ((Trbuf_t*)sh.tracebuf)->ev;
+		}
+		trline(out,&head,&ev,stack,&depth);
+	}
+	free(stack);
+	return 0;
+}
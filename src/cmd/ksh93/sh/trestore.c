@@ -124,6 +124,7 @@ static Shnode_t *r_tree(void)
 			else
 				t->sw.swio = 0;
 			t->sw.swlst = r_switch();
+			t->sw.swhash = sh_swhash(t->sw.swlst);
 			break;
 		case TFUN:
 		{
@@ -765,6 +765,26 @@ static Namval_t *enter_namespace(Namval_t *nsp)
 }
 #endif /* SHOPT_NAMESPACE */
 
+/*
+ * Return true if the word <r> matches any pattern of case arm <reg>.
+ */
+static int casematch(const struct regnod *reg, char *r, int flags)
+{
+	struct argnod *rex;
+	for(rex=reg->regptr; rex; rex=rex->argnxt.ap)
+	{
+		const unsigned char raw = rex->argflag & ARG_RAW;
+		char *s;
+		if(rex->argflag&ARG_MAC)
+			s = sh_macpat(rex,(flags & ARG_OPTIMIZE)|ARG_EXP);
+		else
+			s = rex->argval;
+		if(raw && strcmp(r,s)==0 || !raw && strmatch(r,s))
+			return 1;
+	}
+	return 0;
+}
+
 /*
  * Check whether to execve(2) the final command or make its redirections permanent.
  */
@@ -826,7 +846,8 @@ int sh_exec(const Shnode_t *t, int flags)
 		&& !t->com.comset					/* no variable assignments list */
 		&& !t->com.comio					/* no I/O redirections */
 		&& !sh_isoption(SH_XTRACE)
-		&& !sh.st.trap[SH_DEBUGTRAP])
+		&& !sh.st.trap[SH_DEBUGTRAP]
+		&& !sh.tracebuf)
 		{
 			/* Execute optimized basic versions of the builtins */
 			if(fp==b_false)
@@ -855,6 +876,7 @@ int sh_exec(const Shnode_t *t, int flags)
 		volatile int	was_errexit = sh_isstate(SH_ERREXIT);
 		volatile int	was_monitor = sh_isstate(SH_MONITOR);
 		volatile int	echeck = 0;
+		const char	*volatile trcmd = 0;	/* command name for the tracebuf end event */
 		sh_offstate(SH_DEFPATH);
 		if(!(flags & sh_state(SH_ERREXIT)))
 			sh_offstate(SH_ERREXIT);
@@ -1060,6 +1082,8 @@ int sh_exec(const Shnode_t *t, int flags)
 				}
 				else if((np!=SYSSET) && sh_isoption(SH_XTRACE))
 					sh_trace(com-command,tflags);
+				if(sh.tracebuf)
+					sh_trevent(TR_START,trcmd=com[0],error_info.line,0);
 				if(trap=sh.st.trap[SH_DEBUGTRAP])
 				{
 					int n = sh_debug(trap,NULL,NULL,com,ARG_RAW);
@@ -2207,31 +2231,40 @@ int sh_exec(const Shnode_t *t, int flags)
 				av[3] = 0;
 				sh_debug(sh.st.trap[SH_DEBUGTRAP], NULL, NULL, av, 0);
 			}
-			t = (Shnode_t*)t->sw.swlst;
-			while(t)
+			if(t->sw.swhash)
 			{
-				struct argnod *rex = t->reg.regptr;
-				while(rex)
+				/*
+				 * Look up the literal arms in the hash index, but first
+				 * try the non-literal arms that precede the arm found.
+				 */
+				struct swhash *hp = t->sw.swhash;
+				struct swent *ep, *hit;
+				for(hit=&hp->swbucket[strhash(r)&hp->swmask]; hit->swkey; hit=&hp->swbucket[(hit-hp->swbucket+1)&hp->swmask])
+					if(strcmp(hit->swkey,r)==0)
+						break;
+				t = hit->swkey ? (Shnode_t*)hit->swreg : 0;
+				for(ep=hp->swslow; ep < &hp->swslow[hp->swnslow]; ep++)
 				{
-					const unsigned char raw = rex->argflag & ARG_RAW;
-					char *s;
-					if(rex->argflag&ARG_MAC)
-						s = sh_macpat(rex,(flags & ARG_OPTIMIZE)|ARG_EXP);
-					else
-						s = rex->argval;
-					if(raw && strcmp(r,s)==0 || !raw && strmatch(r,s))
+					if(t && ep->swnum > hit->swnum)
+						break;
+					if(casematch(ep->swreg,r,flags))
 					{
-						do
-							sh_exec(t->reg.regcom, t->reg.regflag ? eflag : flags);
-						while(t->reg.regflag && (t = (Shnode_t*)t->reg.regnxt));
-						t=0;
+						t = (Shnode_t*)ep->swreg;
 						break;
 					}
-					else
-						rex=rex->argnxt.ap;
 				}
-				if(t)
-					t=(Shnode_t*)t->reg.regnxt;
+			}
+			else
+			{
+				t = (Shnode_t*)t->sw.swlst;
+				while(t && !casematch(&t->reg,r,flags))
+					t = (Shnode_t*)t->reg.regnxt;
+			}
+			if(t)
+			{
+				do
+					sh_exec(t->reg.regcom, t->reg.regflag ? eflag : flags);
+				while(t->reg.regflag && (t = (Shnode_t*)t->reg.regnxt));
 			}
 			break;
 		    }
@@ -2424,7 +2457,7 @@ int sh_exec(const Shnode_t *t, int flags)
 			}
 			if(!np->nvalue)
 			{
-				np->nvalue = new_of(struct Ufunction,sh.funload?sizeof(Dtlink_t):0);
+				np->nvalue = sh_mallocx(sizeof(struct Ufunction)+(sh.funload?sizeof(Dtlink_t):0),MEM_FUNCS);
 				memset(np->nvalue,0,sizeof(struct Ufunction));
 			}
 			if(t->funct.functstak)
@@ -2561,6 +2594,8 @@ int sh_exec(const Shnode_t *t, int flags)
 			break;
 		    }
 		}
+		if(trcmd && sh.tracebuf)
+			sh_trevent(TR_END,trcmd,error_info.line,sh.exitval);
 		if(sh.trapnote || (sh.exitval && sh_isstate(SH_ERREXIT)) && t && echeck)
 			sh_chktrap();
 		/* set $_ */
@@ -3009,6 +3044,8 @@ int sh_funscope(int argn, char *argv[],int(*fun)(void*),void *arg,int execflg)
 		}
 		sh.fn_depth++;
 		update_sh_level();
+		if(!fun && sh.tracebuf)
+			sh_trevent(TR_CALL,argv[0],buffp->err.line,0);
 		if(fun)
 			r= (*fun)(arg);
 		else
@@ -3034,6 +3071,8 @@ int sh_funscope(int argn, char *argv[],int(*fun)(void*),void *arg,int execflg)
 		}
 	}
 	sh.invoc_local = save_invoc_local;
+	if(!fun && sh.tracebuf && sh.fn_depth)
+		sh_trevent(TR_RETURN,argv[0],error_info.line,jmpval?sh.exitval:r);
 	sh.fn_depth--;
 	update_sh_level();
 	if(sh.fn_depth==1 && jmpval==SH_JMPERRFN)
@@ -3111,7 +3150,11 @@ static void sh_funct(Namval_t *np,int argn, char *argv[],struct argnod *envlist,
 		opt_info.index = opt_info.offset = 0;
 		error_info.errors = 0;
 		sh.st.loopcnt = 0;
+		if(sh.tracebuf)
+			sh_trevent(TR_CALL,argv[0],sh.st.lineno,0);
 		b_dot_cmd(argn+1,argv-1,&sh.bltindata);
+		if(sh.tracebuf)
+			sh_trevent(TR_RETURN,argv[0],error_info.line,sh.exitval);
 		sh.st.loopcnt = loopcnt;
 		argv[-1] = save;
 	}
@@ -1467,6 +1467,48 @@ got="$($SHELL -i "$hist_error_leak" 2>&1)"
 [[ $exp == "$got" ]] || err_exit "file descriptor leak after substitution error in hist builtin" \
 	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
 
+# History searches use the index in $HISTFILE.idx, which must pick up commands
+# that other shells (with or without an index) appended to the history file
+histfile=$tmp/hist_index
+for ((i=0; i<500; i++)) do print "true filler $i"; done > "$tmp/hist_index_fill.sh"
+cat > "$tmp/hist_index_child.sh" <<-\EOF
+	print appended
+	printf 'print raw\n\0' >> "$HISTFILE"
+EOF
+cat > "$tmp/hist_index.sh" <<-EOF
+	"$SHELL" -i "$tmp/hist_index_fill.sh"
+	true needle
+	hist -ln 'true need' 'true need'
+	[[ -f \$HISTFILE.idx ]] && print idx
+	"$SHELL" -i "$tmp/hist_index_child.sh"
+	hist -ln 'print appe' 'print appe'
+	hist -ln 'print ra' 'print ra'
+	hist -ln 'true filler 250' 'true filler 250'
+	hist -ln 'true nomatch' 2>/dev/null || print notfound
+EOF
+exp=$'\ttrue needle\nidx\nappended\n\tprint appended\n\tprint raw\n\ttrue filler 250\nnotfound'
+got=$(HISTFILE=$histfile HISTSIZE=1000 ENV=/./dev/null "$SHELL" -i "$tmp/hist_index.sh" 2>&1)
+[[ $got == "$exp" ]] || err_exit "history search with index" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# a damaged index is rebuilt
+print garbage > "$histfile.idx"
+got=$(HISTFILE=$histfile HISTSIZE=1000 ENV=/./dev/null "$SHELL" -i "$tmp/hist_index.sh" 2>&1)
+[[ $got == "$exp" ]] || err_exit "history search with damaged index" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# shells appending to the same history file at the same time must not lose or renumber commands
+histfile=$tmp/hist_append
+for ((j=0; j<4; j++)) do
+	for ((i=0; i<200; i++)) do print "true append $j $i"; done > "$tmp/hist_append_$j.sh"
+done
+for ((j=0; j<4; j++)) do
+	HISTFILE=$histfile ENV=/./dev/null "$SHELL" -i "$tmp/hist_append_$j.sh" &
+done
+wait
+got=$(HISTFILE=$histfile HISTSIZE=1000 ENV=/./dev/null "$SHELL" -ic 'hist -ln 1 | grep -c "^.true append"; hist -ln 1 | sort | uniq -d | wc -l')
+exp=$'800\n0'
+[[ ${got//[[:blank:]]/} == "$exp" ]] || err_exit "concurrent history appends" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 fi # !SHOPT_SCRIPTONLY
 
 # ======
@@ -1748,5 +1790,177 @@ got=$(set +x; { (ulimit -c 0; set --state=foo); } 2>&1)
 let "(e=$?) == 2" || err_exit "crash on unexpected option value" \
 	"(got status $e$( ((e>128)) && print -n /SIG && kill -l "$e"), $(printf %q "$got"))"
 
+# ======
+# parmap runs a command on input items in parallel but writes their output in input order
+got=$(printf '%s\n' 3 1 2 | parmap -j3 "$SHELL" -c 'sleep .$1; print "item $1"' x)
+exp=$'item 3\nitem 1\nitem 2'
+[[ $got == "$exp" ]] || err_exit "parmap output not in input order" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+function pmfn { print -r -- "$#:$*"; return $(($1 % 5)); }
+got=$(for ((i=1; i<=7; i++)); do print $i; done | parmap -j2 -n3 pmfn)
+exp=$'3:1 2 3\n3:4 5 6\n1:7'
+[[ $got == "$exp" ]] || err_exit "parmap -n with a shell function" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+for ((i=1; i<=7; i++)); do print $i; done | parmap -j2 -n3 pmfn >/dev/null
+let "(e=$?) == 4" || err_exit "parmap does not return the highest exit status (got $e)"
+got=$(print $'a  b\tc\n\nd' | parmap -w print -r --)
+exp=$'a\nb\nc\nd'
+[[ $got == "$exp" ]] || err_exit "parmap -w" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(print -n 'no newline' | parmap print -r --)
+[[ $got == 'no newline' ]] || err_exit "parmap loses last line without newline (got $(printf %q "$got"))"
+got=$(parmap print </dev/null; print $?)
+[[ $got == 0 ]] || err_exit "parmap with empty input (got $(printf %q "$got"))"
+got=$(for ((i=1; i<=4; i++)); do print $i; done | parmap -j4 "$SHELL" -c 'typeset -i i=0; while ((i++ < 20000)); do print $1; done' x | uniq -c | awk '{print $1 ":" $2}')
+exp=$'20000:1\n20000:2\n20000:3\n20000:4'
+[[ $got == "$exp" ]] || err_exit "parmap mixes up large outputs" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(print x | parmap "$SHELL" -c 'read -r y; print -r "[$y]"' 2>&1)
+[[ $got == '[]' ]] || err_exit "parmap workers do not read from /dev/null (got $(printf %q "$got"))"
+# running out of file descriptors stops parmap from starting workers, but the running ones are finished
+got=$("$SHELL" -c '
+	function pmsleep { sleep .1; print $1; }
+	ulimit -n 14
+	for ((i=0; i<20; i++)); do print $i; done | parmap -j10 pmsleep >pm.out
+	print "status $?"
+	jobs
+	i=0
+	while read -r n && ((n == i)); do ((i++)); done <pm.out
+	print "in order $((i > 1 && i == $(wc -l <pm.out)))"
+' 2>&1)
+[[ $got == *': parmap: cannot create pipe'*$'\nstatus 1\nin order 1' ]] \
+	|| err_exit "parmap does not finish its workers when it cannot create a pipe (got $(printf %q "$got"))"
+
+# ======
+# mkservice connections do not block: a client that sends part of a line must not stall the others
+if ((SHOPT_MKSERVICE)); then
+port=$((20000 + $$ % 20000))
+(
+	mkservice svc /dev/tcp/localhost/$port || exit
+	typeset -A part
+	function svc.action
+	{
+		typeset line
+		if	read -r -u$1 line
+		then	print -r -u$1 -- "${part[$1]}$line"
+			part[$1]=
+		else	part[$1]+=$line
+			return 1	# no complete line yet
+		fi
+	}
+	eloop -t 5000
+) &
+server=$!
+SECONDS=0
+until	(exec 3<>/dev/tcp/localhost/$port) 2>/dev/null
+do	((SECONDS < 5)) || break
+	sleep .05
+done
+if	exec 4<>/dev/tcp/localhost/$port 5<>/dev/tcp/localhost/$port
+then	print -n -u4 'hel'
+	sleep .1
+	print -u5 other
+	read -r -t 2 -u5 got
+	[[ $got == other ]] || err_exit "mkservice blocks on a partial line from another connection (got $(printf %q "$got"))"
+	print -u4 'lo'
+	read -r -t 2 -u4 got
+	[[ $got == hello ]] || err_exit "mkservice loses a line sent in two parts (got $(printf %q "$got"))"
+	exec 4>&- 5>&-
+else	err_exit "cannot connect to mkservice on port $port"
+fi
+kill $server 2>/dev/null
+# running out of descriptors must not make the event loop spin; waiting connections are served later
+port=$((port + 1))
+(
+	ulimit -n 24
+	mkservice svc /dev/tcp/localhost/$port || exit
+	function svc.action
+	{
+		typeset line
+		read -r -u$1 line && print -r -u$1 -- "$line"
+	}
+	TIMEFORMAT='%U %S'
+	time eloop -t 1500
+) 2>$tmp/eloop.time &
+server=$!
+SECONDS=0
+until	(exec 3<>/dev/tcp/localhost/$port) 2>/dev/null
+do	((SECONDS < 5)) || break
+	sleep .05
+done
+typeset -a cfd
+for ((i=0; i<40; i++))
+do	exec {fd}<>/dev/tcp/localhost/$port || break
+	cfd[i]=$fd
+done
+sleep 1
+n=0
+for ((i=0; i<${#cfd[@]}; i++))
+do	print -u${cfd[i]} $i
+	read -r -t 2 -u${cfd[i]} got && ((got == i)) && ((n++))
+	exec {cfd[i]}>&-
+done
+[[ $n == 40 ]] || err_exit "mkservice does not serve connections that waited for a descriptor (got $n of 40)"
+for ((i=0; i<50; i++))
+do	kill -0 $server 2>/dev/null || break
+	sleep .1
+done
+if	kill -9 $server 2>/dev/null
+then	err_exit "mkservice event loop does not time out after running out of descriptors"
+else	wait $server
+	read user sys <$tmp/eloop.time
+	((user + sys < .5)) || err_exit "mkservice event loop busy-waits when out of descriptors (CPU time $user + $sys)"
+fi
+unset cfd
+fi # SHOPT_MKSERVICE
+
+# ======
+# searching empty plugin directories, both just modified and older, for a library
+mkdir -p "$tmp/plugins/bin" "$tmp/plugins/lib/ksh"
+for t in '' 202001010000
+do	[[ $t ]] && touch -t "$t" "$tmp/plugins/lib/ksh" "$tmp/plugins/lib"
+	got=$(PATH=$tmp/plugins/bin:$PATH "$SHELL" -c 'for i in 1 2 3; do builtin -f nosuchlib nosuch; done 2>/dev/null; echo ok' 2>&1)
+	[[ $got == ok ]] || err_exit "builtin -f with empty plugin directories${t:+ (mtime $t)} (got $(printf %q "$got"))"
+done
+
+# ======
+# tracebuf records command and function events in a ring buffer
+cat >$tmp/tracebuf.sh <<\EOF
+tracebuf -n 100
+function trf { true; return 3; }
+trf
+false
+tracebuf -w "$1" || exit
+tracebuf -n 0
+tracebuf
+EOF
+got=$("$SHELL" "$tmp/tracebuf.sh" "$tmp/trace")
+[[ $got == '' ]] || err_exit "tracebuf prints events after recording was stopped (got $(printf %q "$got"))"
+got=$(tracebuf -r "$tmp/trace" | sed 's/^[^ ]* \[[0-9]*\] //; s/, [0-9.]*s)/)/')
+exp=$'3: start trf\n3:   call trf\n2:   start true\n2:   end true (status 0)\n2:   start return\n2:   return trf (status 3)\n3: end trf (status 3)\n4: start false\n4: end false (status 1)\n5: start tracebuf'
+[[ $got == "$exp" ]] || err_exit "tracebuf timeline" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$("$SHELL" -c 'tracebuf -n 3; true; true; true; tracebuf' | sed 's/^[^ ]* \[[0-9]*\] //; s/, [0-9.]*s)/)/')
+exp=$'# 4 earlier events were overwritten\n1: start true\n1: end true (status 0)\n1: start tracebuf'
+[[ $got == "$exp" ]] || err_exit "tracebuf does not keep the last events" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(tracebuf -n 10; true; tracebuf -c; tracebuf)
+[[ $got == *' start tracebuf' && $got != *true* ]] || err_exit "tracebuf -c does not clear (got $(printf %q "$got"))"
+got=$(tracebuf -r /dev/null 2>&1)
+(($? == 1)) && [[ $got == *'not a tracebuf file' ]] || err_exit "tracebuf -r accepts a bad file (got $(printf %q "$got"))"
+n=$(wc -c <"$tmp/trace")
+head -c $((n - 10)) "$tmp/trace" >"$tmp/trace.short"
+got=$(tracebuf -r "$tmp/trace.short" 2>&1)
+(($? == 1)) && [[ $got == *': truncated tracebuf file' && $got != *start* ]] \
+	|| err_exit "tracebuf -r prints a truncated file (got $(printf %q "$got"))"
+got=$(tracebuf -r <(cat "$tmp/trace.short") 2>&1)
+(($? == 1)) && [[ $got == *': truncated tracebuf file' ]] \
+	|| err_exit "tracebuf -r of a truncated file from a pipe (got $(printf %q "$got"))"
+# POSIX functions are traced too
+got=$("$SHELL" -c $'tracebuf -n 100\npf() { false; }\npf\ntracebuf' | sed 's/^[^ ]* \[[0-9]*\] //; s/, [0-9.]*s)/)/')
+exp=$'3: start pf\n3: call pf\n2: start false\n2: end false (status 1)\n3: return pf (status 1)\n3: end pf (status 1)\n4: start tracebuf'
+[[ $got == "$exp" ]] || err_exit "tracebuf timeline of POSIX function" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
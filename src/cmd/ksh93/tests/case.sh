@@ -195,5 +195,35 @@ got=$(set +x; eval '
 [[ $got == "$exp" ]] || err_exit "spurious syntax error in case with extended expression" \
 	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
 
+# ======
+# Case statements with many literal patterns are dispatched through a hash index;
+# the first matching arm must still win, including non-literal arms that precede it.
+function dispatch
+{
+	case $1 in
+	a|b|c)		print abc ;;
+	d|"e"|'f')	print def ;;
+	g*)		print g-glob ;;
+	gh|ij|kl)	print ghijkl ;;
+	$2)		print param ;;
+	mn|op|qr|b)	print mnopqr ;;
+	st|uv)		print stuv ;&
+	wx|yz)		print wxyz ;;
+	\*|'?')		print literal-glob ;;
+	*)		print default ;;
+	esac
+}
+for arg in a b e f gh ghx ij kl mn st wx '*' '?' zz qq
+do	print -r -- "$arg $(dispatch "$arg" zz)"
+done > out
+exp=$'a abc\nb abc\ne def\nf def\ngh g-glob\nghx g-glob\nij ghijkl\nkl ghijkl\nmn mnopqr\nst stuv\nwxyz\nwx wxyz\n* literal-glob\n? literal-glob\nzz param\nqq default'
+got=$(<out)
+[[ $got == "$exp" ]] || err_exit "hashed case dispatch gives wrong result" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(set +x; eval 'function f { case $1 in a|b|c|d|e|f|g|h|i) print ok ;; esac; }; f e; f x' 2>&1)
+[[ $got == ok ]] || err_exit "hashed case dispatch in function fails (got $(printf %q "$got"))"
+got=$(set +x; "$SHELL" -c 'case x in a|b|c|d|e|f|g|h|i|x) print ok ;; esac' 2>&1)
+[[ $got == ok ]] || err_exit "hashed case dispatch at top level fails (got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
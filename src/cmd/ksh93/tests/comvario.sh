@@ -640,12 +640,38 @@ function test_read_C_special_shell_keywords
 	return 0
 }
 
+# the name of a declaration in a compound assignment must survive an input buffer refill
+function test_read_C_buffer_boundary
+{
+	compound c
+	typeset err
+	integer i pad
+
+	for (( pad=0 ; pad < 24 ; pad++ )) ; do
+		{
+			print '('
+			printf '\t#%*s\n' pad ''
+			for (( i=0 ; i < 4096 ; i++ )) ; do
+				printf '\tinteger var%d=%d\n\ttypeset str%d+=%d\n' i i i i
+			done
+			print ')'
+		} > read_C_boundary.in
+		read -C c < read_C_boundary.in 2> read_C_boundary.err
+		err=$(< read_C_boundary.err)
+		[[ $err == '' ]] || { err_exit "read -C with padding ${pad}: got error $(printf %q "$err")" ; continue ; }
+		[[ ${c.var4095} == 4095 && ${c.str4095} == 4095 ]] || err_exit "read -C with padding ${pad}: values lost"
+	done
+
+	return 0
+}
+
 
 test_3D_array_read_C
 test_access_2Darray_in_type_in_compound
 test_read_type_crash
 test_read_C_into_array
 test_read_C_special_shell_keywords
+test_read_C_buffer_boundary
 
 # tests done
 exit $((Errors<125?Errors:125))
@@ -554,5 +554,30 @@ _EOF"; } 2>&1 )
 	"(expected status 0, '$exp';" \
 	"got status $e$( ((e>128)) && print -n /SIG && kill -l "$e"), $(printf %q "$got"))"
 
+# ======
+# Here-documents and here-strings are stored in an anonymous memory file where
+# available; the file must be readable through another fd and be seekable
+exp=$'a 1\nb 1\nsecond'
+got=$(set +x; "$SHELL" -c 'x=1
+	exec 4<<EOF
+a $x
+b $x
+EOF
+	cat <&4; exec 4<&-
+	{ read -r; read -r; } <<<$'"'first\\nsecond'"'; print -r -- "$REPLY"' 2>&1)
+[[ $got == "$exp" ]] || err_exit "here-document read through redirected fd" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+exp=$'abc\nabc'
+got=$(set +x; "$SHELL" -c 'exec 3<<<abc; cat <&3; redirect 3<#((0)); cat <&3' 2>&1)
+[[ $got == "$exp" ]] || err_exit "here-string file is not seekable" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+if	((SHOPT_STATS))
+then	got=$("$SHELL" -c 'cat <<<x >/dev/null; cat <<-EOF >/dev/null
+		y
+		EOF
+		print $((.sh.stats.heredoc_memfd + .sh.stats.heredoc_tmpfile))')
+	[[ $got == 2 ]] || err_exit "here-document counters in .sh.stats (expected 2, got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
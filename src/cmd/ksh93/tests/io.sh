@@ -1064,5 +1064,31 @@ let "$? <= 128" || err_exit "crash on huge RLIMIT_NOFILE"
 (ulimit -n 8; "$SHELL" --version) 2>/dev/null
 let "$? <= 128" || err_exit "crash on tiny RLIMIT_NOFILE"
 
+# ======
+# Output of print, printf and echo to a file or pipe is buffered across commands,
+# but must still be written in order with other output and before blocking
+if	[[ -r /proc/self/io ]]
+then	got=$(set +x; "$SHELL" -c 'for ((i=0; i<1000; i++)); do print $i; printf "%d\n" $i; echo $i; done >"$1"
+		while read -r n v; do [[ $n == syscw: ]] && print -r -- "$v"; done </proc/$$/io' _ "$tmp/syscw.out" 2>&1)
+	[[ $got == +([0-9]) ]] && ((got <= 10)) || err_exit "buffered builtin output: too many write(2) calls" \
+		"(expected at most 10, got $(printf %q "$got"))"
+fi
+exp='a b c d e f g h kj l m n o p q'
+got=$(set +x; "$SHELL" -c '{ print a; print b >&2; print c; printf "d\n"; echo e >&2; "$1" f; print g
+	(print h); x=$(print j; "$1" -n); print "k$x"; print l | cat; print m; wait; print n; cat <<<o
+	read q <<<p; print "$q"; print q >&2; } 2>&1' _ "$(whence -p echo)" | tr '\n' ' ')
+[[ ${got% } == "$exp" ]] || err_exit "buffered builtin output out of order" \
+	"(expected $(printf %q "$exp"), got $(printf %q "${got% }"))"
+"$SHELL" -c 'while read -r x; do print "got $x"; done' |&
+print -p a; read -t 5 -p r1; print -p b; read -t 5 -p r2
+exec 5>&p 5>&-
+wait
+got="$r1, $r2"
+[[ $got == 'got a, got b' ]] || err_exit "buffered builtin output not written before reading from pipe" \
+	"(got $(printf %q "$got"))"
+if	[[ -c /dev/full ]]
+then	{ print hi; } >/dev/full && err_exit "buffered builtin output: write error not detected on restoring redirection"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
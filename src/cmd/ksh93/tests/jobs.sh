@@ -94,5 +94,30 @@ got=$(set +x; ENV=$tmp/profile "$SHELL" -i </dev/null 2>&1)
 [[ -n $got ]] && err_exit "subshell bg job in profile script prints job number (got $(printf %q "$got"))"
 fi # !SHOPT_SCRIPTONLY
 
+# ======
+# The exit status of each of many background jobs must be kept for 'wait', also across a subshell
+got=$(
+	integer i s n=300
+	typeset -a pids
+	for ((i=0; i<n; i++))
+	do	(exit $((i%100))) &
+		pids[i]=$!
+	done
+	(
+		for ((i=0; i<n; i++))
+		do	(exit 7) &
+		done
+		wait $!
+		s=$?
+		((s==7)) || print -r -- "subshell job: status $s"
+	)
+	for ((i=n-1; i>=0; i--))
+	do	wait ${pids[i]}
+		s=$?
+		((s==i%100)) || print -r -- "job $i: status $s"
+	done
+)
+[[ -z $got ]] || err_exit "wrong exit status of background jobs (got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -0,0 +1,139 @@
+########################################################################
+#                                                                      #
+#               This software is part of the ast package               #
+#            Copyright (c) 2026 Contributors to ksh 93u+m              #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 2.0                  #
+#                                                                      #
+#                A copy of the License is available at                 #
+#      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      #
+#         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         #
+#                                                                      #
+########################################################################
+
+. "${SHTESTS_COMMON:-${0%/*}/_common}"
+
+# ======
+# print -j
+
+compound c=(
+	a='x y'
+	integer n=42
+	float f=1.5
+	typeset -a arr=(1 2 3)
+	typeset -A as=([k1]=v1 [k2]=v2)
+	m=(z=$'q"\\\n\t\1')
+	typeset -a ca=((x=1) (x=2))
+	typeset -a empty=()
+)
+exp='{"a":"x y","arr":["1","2","3"],"as":{"k1":"v1","k2":"v2"},"ca":[{"x":"1"},{"x":"2"}],"empty":[],"f":1.5,"m":{"z":"q\"\\\n\t\u0001"},"n":42}'
+got=$(print -j c)
+[[ $got == "$exp" ]] || err_exit 'print -j of compound variable' \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+exp=$'["1","2","3"]\n{"k1":"v1","k2":"v2"}\n42\nnull'
+got=$(unset nosuch; print -j c.arr c.as c.n nosuch)
+[[ $got == "$exp" ]] || err_exit 'print -j of arrays and scalars' \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+got=$(set -u; print -j nosuch 2>&1)
+[[ $got == *'nosuch: parameter not set' ]] || err_exit 'print -j ignores set -u' "(got $(printf %q "$got"))"
+
+got=$(print -j -f %s c 2>&1)
+[[ $got == *'mutually exclusive'* ]] || err_exit 'print -j -f not rejected' "(got $(printf %q "$got"))"
+
+got=$(float -X x=1.5; typeset -li -i16 h=255; print -j x h)
+[[ $got == $'1.5\n255' ]] || err_exit 'print -j of number not in base 10' "(got $(printf %q "$got"))"
+
+# ======
+# read -j
+
+json='{"a":1,"b":[1,2.5,"x",{"q":true,"r":null}],"c":{"d":"eé\n","e":[]},"f":-3e2,"g":[[1,2],["s"]],"h":{},"i":[4,5]}'
+print -r -- "$json" | read -j v
+[[ ${v.a} == 1 && ${v.b[2]} == x && ${v.b[3].q} == true && ${v.c.d} == $'eé\n' && ${v.f} == -3e+02 ]] \
+	|| err_exit 'read -j assigns wrong values' "(got $(typeset -p v))"
+[[ ${v.g[1][0]} == s && ${#v.g[0][@]} == 2 ]] || err_exit 'read -j into multidimensional array' "(got $(typeset -p v.g))"
+[[ -v v.b[3].r ]] && err_exit 'read -j assigns null'
+[[ $(typeset -p v.a) == 'typeset -l -i v.a=1' ]] || err_exit 'read -j does not make integers integer' "(got $(typeset -p v.a))"
+[[ $(typeset -p v.i) == 'typeset -a -l -i v.i=(4 5)' ]] || err_exit 'read -j does not make integer arrays integer' "(got $(typeset -p v.i))"
+exp='{"a":1,"b":["1","2.5","x",{"q":"true"}],"c":{"d":"eé\n","e":[]},"f":-300,"g":[["1","2"],["s"]],"h":{},"i":[4,5]}'
+got=$(print -j v)
+[[ $got == "$exp" ]] || err_exit 'print -j of variable read by read -j' \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+print -r -- '"😀 é \/ \\"' | read -j s
+[[ $s == $'\U1F600 é / \\' ]] || err_exit 'read -j decodes \u escapes incorrectly' "(got $(printf %q "$s"))"
+
+print '{"a":1,"a":"$(echo bad)"}' | read -j d
+[[ ${d.a} == '$(echo bad)' && $(typeset -p d.a) != *-i* ]] || err_exit 'read -j with duplicate member' "(got $(typeset -p d))"
+
+exp=$'{"n":1}\n{"n":[2]}\nend'
+got=$(printf '{"n":1}\n  {"n":\n[2]}  \n' | { while read -j o; do print -j o; done; print end; })
+[[ $got == "$exp" ]] || err_exit 'read -j loop over lines' \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
+for json in '{"a":' '{"bad key":1}' '[1,]' '{"a" 1}' '"\x"' '-' '1.' 'nul' '"\u0000"'
+do	got=$(print -r -- "$json" | read -j e 2>&1; print "status $?")
+	[[ $got == *'in JSON input'*'status 2' ]] || err_exit "read -j accepts invalid JSON $(printf %q "$json")" \
+		"(got $(printf %q "$got"))"
+done
+got=$(print -n '' | read -j e; print $?)
+[[ $got == 1 ]] || err_exit 'read -j at end of file' "(got $got)"
+
+function f
+{
+	typeset -C loc
+	print '{"a":{"b":2}}' | read -j loc
+	print -j loc
+}
+got=$(f; print -j loc)
+[[ $got == $'{"a":{"b":2}}\nnull' ]] || err_exit 'read -j into local variable' "(got $(printf %q "$got"))"
+
+typeset -a arr=(1 2 3)
+print '{"x":"s"}' | read -j 'arr[1]'
+[[ ${arr[1].x} == s && ${arr[2]} == 3 ]] || err_exit 'read -j into array element' "(got $(typeset -p arr))"
+
+# a round trip of a large document
+{
+	print '{"items":['
+	for ((i=0; i<2000; i++))
+	do	((i)) && print ','
+		print "{\"id\":$i,\"name\":\"item $i\",\"tags\":[\"a\",\"b\"],\"meta\":{\"x\":$((i*2))}}"
+	done
+	print '],"count":2000}'
+} > $tmp/big.json
+read -j big < $tmp/big.json
+[[ ${big.count} == 2000 && ${big.items[1999].name} == 'item 1999' && ${big.items[7].meta.x} == 14 ]] \
+	|| err_exit 'read -j of large document'
+print -j big | read -j big2
+[[ $(print -j big2) == "$(print -j big)" ]] || err_exit 'round trip through print -j and read -j'
+cat $tmp/big.json | read -j big3
+[[ $(print -j big3) == "$(print -j big)" ]] || err_exit 'read -j of a document spanning lines in a pipe'
+
+# input after the line with the value is left for the next command
+got=$(printf '{"a":1}\nrest\n' | "$SHELL" -c 'read -j x; cat')
+[[ $got == rest ]] || err_exit 'read -j reads past the value in a pipe' "(got $(printf %q "$got"))"
+got=$(printf '[1,\n2] more\nrest\n' | "$SHELL" -c 'read -j x; read y; print -j x; print -r -- "$y"; cat')
+[[ $got == $'[1,2]\nmore\nrest' ]] || err_exit 'read -j leaves the rest of the line' "(got $(printf %q "$got"))"
+
+# an empty array is not null
+read -j y <<<'[]'
+[[ $(print -j y) == '[]' ]] || err_exit 'empty array does not round trip' "(got $(print -j y))"
+
+# enumeration values are strings
+enum Json_color_t=(red green blue)
+Json_color_t jc=green
+compound jo=(Json_color_t e=blue; typeset -i n=3)
+[[ $(print -j jc) == '"green"' ]] || err_exit 'enum printed as a number' "(got $(print -j jc))"
+[[ $(print -j jo) == '{"e":"blue","n":3}' ]] || err_exit 'enum member printed as a number' "(got $(print -j jo))"
+
+# multidimensional arrays
+read -j md <<<'[[1,2],["s",true,null,false],[[3]],[{"k":"v"}]]'
+[[ ${md[1][0]} == s && ${md[1][3]} == false && ! -v md[1][2] && ${md[2][0][0]} == 3 && ${md[3][0].k} == v ]] \
+	|| err_exit 'read -j of nested arrays' "(got $(typeset -p md))"
+read -j md <<<'[[1,2],["s",true],[[3]],[{"k":"v"}]]'
+[[ $(print -j md) == '[["1","2"],["s","true"],[["3"]],[{"k":"v"}]]' ]] \
+	|| err_exit 'print -j of nested arrays' "(got $(print -j md))"
+
+# ======
+exit $((Errors<125?Errors:125))
@@ -431,5 +431,32 @@ DO
 	(((foo = amet) && foo == amet && foo != fermentum))
 DONE
 
+# ======
+# .sh.mem attributes allocations to the subsystem that made them
+if	((SHOPT_STATS))
+then	got=$("$SHELL" -c '
+		integer v=.sh.mem.vars_allocs f=.sh.mem.funcs_allocs s=.sh.mem.stk_inuse
+		typeset -A assoc
+		for ((i=0; i<100; i++))
+		do	assoc[$i]=$i
+		done
+		function fn { :; }
+		x=$(printf %0100000d 0)
+		print $((.sh.mem.vars_allocs - v >= 100)) $((.sh.mem.funcs_allocs - f)) \
+			$((.sh.mem.stk_peak - s >= 100000)) $((.sh.mem.stk_inuse <= .sh.mem.stk_peak))
+	' 2>&1)
+	[[ $got == '1 1 1 1' ]] || err_exit "wrong allocation counts in .sh.mem (got $(printf %q "$got"))"
+	# where the old size of a block is known, a realloc counts only the growth
+	got=$("$SHELL" -c '
+		x=
+		integer b=.sh.mem.vars_bytes
+		for ((i=0; i<2000; i++))
+		do	x+=0123456789
+		done
+		print $((.sh.mem.vars_bytes - b < 40000))
+	' 2>&1)
+	[[ $got == 1 || $(uname -s) != Linux && $got == 0 ]] || err_exit "wrong realloc byte count in .sh.mem (got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
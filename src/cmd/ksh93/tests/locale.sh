@@ -484,5 +484,32 @@ then	LANG=C.UTF-8
 		"(expected $(printf %q "$exp"); got $(printf %q "$got"))"
 fi
 
+# ======
+# LANG and LC_ALL defer loading the categories other than LC_CTYPE and LC_NUMERIC
+# until they are used; check that they still take effect when they are
+if	((SHOPT_MULTIBYTE))
+then	exp=$'1\nb c ä\n2024-02-29\nC.UTF-8\nC.UTF-8'
+	got=$(set +x; unset LANG "${!LC_@}"; mkdir "$tmp/lazy_lc" && cd "$tmp/lazy_lc" && touch c ä b || exit
+	LANG=C.UTF-8 "$SHELL" -c 's=ä; print ${#s}; print *; printf "%(%Y-%m-%d)T\n" "2024-02-29 12:00"; [[ a < b && ä > b ]] || print wrong order'
+	LC_ALL=C.UTF-8 "$SHELL" -c 'print $LC_ALL; LC_MESSAGES=C; LC_ALL=C.UTF-8; print $LC_ALL' 2>&1)
+	[[ $got == "$exp" ]] || err_exit "deferred locale categories" \
+		"(expected $(printf %q "$exp"); got $(printf %q "$got"))"
+fi
+
+# ======
+# In UTF-8 locales, ${#v}, ${v:o:l} and ${v%p} scan ASCII runs a word at a time and
+# decode valid UTF-8 inline; strings with invalid bytes must give the same results as before
+if	((SHOPT_MULTIBYTE))
+then	exp=$'82 aaéa 80 40\n42 aaa😀 40 0\n81 $\'aa\\x[ff]a\' 80 40\n40 aa 39 0\n41 aaa 40 0'
+	got=$(set +x; LC_ALL=C.UTF-8
+	s=aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
+	for v in "${s}é${s}€" "é${s}😀" "${s}"$'\xff'"${s}" $'\xe2\x82'"${s}" $'\xc0\x80'"${s}"
+	do	x=${v:38:4} y=${v%a*} z=${v%%[!a]*}
+		print -r -- "${#v} $(printf %q "$x") ${#y} ${#z}"
+	done)
+	[[ $got == "$exp" ]] || err_exit "UTF-8 string operations" \
+		"(expected $(printf %q "$exp"); got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -219,6 +219,23 @@ T '#236961303'				'1977-07-05 17:35:03'
 export TZ=Europe/London
 T '#0'					'1970-01-01 01:00:00'
 
+# ISO 8601 and RFC 3339 date-times are converted by a fast path in tmxdate(3)
+# that must give the same results as the general parser
+C='ISO 8601 date-times'
+format='%Y-%m-%d %H:%M:%S.%3N %Z'
+export TZ=America/New_York
+T '2024-03-05T12:34:56Z'		'2024-03-05 07:34:56.000 EST'
+T '2024-03-05t12:34:56.25z'		'2024-03-05 07:34:56.250 EST'
+T '2024-03-05 12:34:56'			'2024-03-05 12:34:56.000 EST'
+T '2024-07-05T12:34'			'2024-07-05 12:34:00.000 EDT'
+T '2024-07-05T12:34:56.123456789Z'	'2024-07-05 08:34:56.123 EDT'
+T '2024-03-05T12:34:56-05:00'		'2024-03-05 12:34:56.000 EST'
+T '2024-03-05T12:34:56+0130'		'2024-03-05 06:04:56.000 EST'
+T '2024-03-05T12:34:56-07'		'2024-03-05 14:34:56.000 EST'
+T '2024-02-29T00:00:00Z'		'2024-02-28 19:00:00.000 EST'
+T '2024-02-30T00:00:00Z'		'2024-02-29 19:00:00.000 EST'
+T '2024-03-05T24:00:00Z'		'2024-03-05 19:00:00.000 EST'
+
 format='%Y-%m-%d'
 export TZ=UTC
 
@@ -559,5 +576,28 @@ got=$(printf '%s%c%c' 1 $'\0' $'\n' 2 $'\0' $'\n' 3 $'\0' $'\n' 4 $'\0' $'\n' |
 	[[ $one != "$two" ]]
 ) || err_exit "printf %T: TZ=UTC sticks after changing TZ"
 
+# ======
+# Formats are compiled once and cached; reusing them must give the same output
+rec=$'[a       |    1] 0x1f 2%\n[b c     |   -2] 0 0%'
+exp=$rec$'\n'$rec$'\n[        |    0] 0 0%'
+got=$(for i in 1 2; do printf '[%-8s|%5d] %#x %d%%\n' a 1 31 2 'b c' -2; done; printf '[%-8s|%5d] %#x %d%%\n')
+[[ $got == "$exp" ]] || err_exit "compiled printf format reused" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+got=$(for i in {1..40}; do printf "$i:%s " x; done; printf '\n')
+exp=$(for i in {1..40}; do print -n "$i:x "; done; print)
+[[ $got == "$exp" ]] || err_exit "printf format cache eviction" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+# a nested printf from an arithmetic function must not invalidate the running format
+exp='<x>6 u <x>8 v '
+got=$(set +x; "$SHELL" -c 'function .sh.math.f x
+	{
+		for i in {1..20}; do printf "$i" >/dev/null; done
+		printf "<%s>" x
+		((.sh.value = x*2))
+	}
+	printf "%d %s " "f(3)" u "f(4)" v' 2>&1)
+[[ $got == "$exp" ]] || err_exit "printf with nested printf in arithmetic function" \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -690,6 +690,54 @@ r ^:test-3: ls vi_completion_A_file\r\n$
 r ^vi_completion_A_file\r\n$
 !
 
+((SHOPT_ESH)) && touch emacs_cache_A_file && VISUAL=emacs tst $LINENO <<"!"
+L emacs: completion sees files created after an earlier completion
+
+d 15
+p :test-1:
+w ls emacs_cache\t
+r ^:test-1: ls emacs_cache_A_file \r\n$
+r ^emacs_cache_A_file\r\n$
+p :test-2:
+w touch emacs_cache_B_file
+p :test-3:
+c ls emacs_cache\E=
+r ^:test-3: 
+r ^1) emacs_cache_A_file\r\n$
+r ^2) emacs_cache_B_file\r\n$
+w _B_file
+r ^:test-3: ls emacs_cache_B_file\r\n$
+r ^emacs_cache_B_file\r\n$
+!
+
+# the directory is dated in the past, so that its listing can be cached
+((SHOPT_ESH)) && mkdir emacs_cachedir && touch emacs_cachedir/A_file && touch -t 202001010000 emacs_cachedir &&
+VISUAL=emacs tst $LINENO <<"!"
+L emacs: completion reuses a cached directory listing until the directory changes
+
+d 15
+p :test-1:
+w ls emacs_cachedir/\t
+r ^:test-1: ls emacs_cachedir/A_file \r\n$
+r ^emacs_cachedir/A_file\r\n$
+p :test-2:
+w touch emacs_cachedir/B_file; touch -t 202001010000 emacs_cachedir
+p :test-3:
+w ls emacs_cachedir/\t
+r ^:test-3: ls emacs_cachedir/A_file \r\n$
+r ^emacs_cachedir/A_file\r\n$
+p :test-4:
+w touch -t 202101010000 emacs_cachedir
+p :test-5:
+c ls emacs_cachedir/\E=
+r ^:test-5: 
+r ^1) A_file\r\n$
+r ^2) B_file\r\n$
+w B_file
+r ^:test-5: ls emacs_cachedir/B_file\r\n$
+r ^emacs_cachedir/B_file\r\n$
+!
+
 tst $LINENO <<"!"
 L syntax error added to history file
 
@@ -1400,5 +1448,46 @@ I print
 r right
 !
 
+# Inserting in the middle of a line that fits on one row uses the terminal's
+# insert character capability instead of rewriting the rest of the line.
+# The raw output of the shell is taken from the byte trace of pty.
+function keybytes
+{
+	typeset mode=$1 move=$2 text
+	integer n=$3 i bytes=0
+	{
+		print -r 'd 20'
+		print -r 'p :test-1:'
+		print -r 'c print 0123456789abcdefghijklmnopqrstuvwxyz0123456789'
+		print -r 's 100'
+		print -r "c $move"
+		print -r 's 100'
+		print -r 'v 2'
+		for ((i=0; i<n; i++))
+		do	print -r 'c X'
+			print -r 's 50'
+		done
+		print -r 'w '
+		print -r 'r ^:test-1:'
+	} | VISUAL=$mode TERM=xterm pty --dialogue --messages=/dev/fd/1 $SHELL |
+	while	read -r text
+	do	[[ $text == 'debug-2: b '* ]] && ((bytes += ${#text}))
+	done
+	print $bytes
+}
+if	((multiline)) && [[ $(TERM=xterm tput ich 1 2>/dev/null) && $(TERM=xterm tput dch1 2>/dev/null) ]]
+then	for mode in emacs vi
+	do	case $mode in
+		emacs)	((SHOPT_ESH)) || continue
+			move='\cA\cF\cF\cF\cF\cF\cF\cF\cF\cF\cF' ;;
+		vi)	((SHOPT_VSH)) || continue
+			move='\E010li' ;;
+		esac
+		# the difference between 15 and 5 inserted characters is the cost of 10 keystrokes
+		(( (got = ($(keybytes $mode "$move" 15) - $(keybytes $mode "$move" 5)) / 10) < 16 )) ||
+			err_exit "$mode: inserting in the middle of a line writes $got bytes per keystroke (expected < 16)"
+	done
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -1083,5 +1083,27 @@ got=${ $SHELL -c 'print ${!.sh.match} ${!.sh.match[1]} ${!.sh.match[2]}' }
 [[ $exp == "$got" ]] || err_exit "'print \${!.sh.match}' should not print excessive elements" \
 	"(expected ${ printf %q "$exp" }, got ${ printf %q "$got" })"
 
+# ======
+# The .sh.match array is only built when it is used, so check that it is
+# built from the last match however it is reached
+s='foo bar foo bar'
+[[ abc == a@(b)c ]]
+: ${s//@(f)o/x}
+: ${s//@(b)@(a)/x}
+nameref r=.sh.match
+exp='ba ba b b a a 2'
+got="${r[0][@]} ${r[1][@]} ${r[2][@]} ${#r[1][@]}"
+[[ $got == "$exp" ]] || err_exit ".sh.match not built through a nameref" \
+	"(expected ${ printf %q "$exp" }, got ${ printf %q "$got" })"
+unset -n r
+: ${s//@(f)o/x}
+( [[ ${.sh.match[1][1]} == f ]] ) || err_exit ".sh.match not built in a subshell"
+exp='fo fo f f'
+got="${.sh.match[0][@]} ${.sh.match[1][@]}"
+[[ $got == "$exp" ]] || err_exit ".sh.match wrong after it was built in a subshell" \
+	"(expected ${ printf %q "$exp" }, got ${ printf %q "$got" })"
+[[ xyz == x@(y)z ]]
+[[ ${.sh.match[1]} == y && ${#.sh.match[@]} == 2 ]] || err_exit ".sh.match not replaced by a later match"
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -878,5 +878,20 @@ Version*93u+m/1.0* | Version*93??\ * | Version*93?\ *)
 	;;
 esac
 
+# ======
+# member values given in the assignment of each element of a typed array must all override the defaults
+typeset -T Member_override_t=(
+	integer id=1
+	float val=2.5
+	typeset -L3 tag=abc
+	str=def
+)
+Member_override_t -a mo=( (id=5 str=x) (val=1.5 tag=xyz) (id=7 val=3 tag=q str=y) )
+mo[3]=(str=z id=9)
+exp='Member_override_t -a mo=((typeset -l -i id=5;typeset -l -E val=2.5;typeset -L 3 tag=abc;str=x) (typeset -l -i id=1;typeset -l -E val=1.5;typeset -L 3 tag=xyz;str=def) (typeset -l -i id=7;typeset -l -E val=3;typeset -L 3 tag=q;str=y) (typeset -l -i id=9;typeset -l -E val=2.5;typeset -L 3 tag=abc;str=z))'
+got=$(typeset -p mo)
+[[ $got == "$exp" ]] || err_exit 'member values of typed array elements not all assigned' \
+	"(expected $(printf %q "$exp"), got $(printf %q "$got"))"
+
 # ======
 exit $((Errors<125?Errors:125))
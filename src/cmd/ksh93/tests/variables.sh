@@ -1172,7 +1172,7 @@ $SHELL -c '
 	PS2=$PS1 PS3=$PS1 PS4=$PS1 OPTARG=$PS1 IFS=$PS1 FPATH=$PS1 FIGNORE=$PS1
 	for var
 	do	case $var in
-		RANDOM | SRANDOM | HISTCMD | _ | SECONDS | LINENO | JOBMAX | .sh.stats | .sh.match)
+		RANDOM | SRANDOM | HISTCMD | _ | SECONDS | LINENO | JOBMAX | .sh.stats | .sh.mem | .sh.match)
 			# these are expected to fail below as their values change; just test against crashing
 			typeset -u "$var"
 			typeset -l "$var"
@@ -1741,5 +1741,18 @@ exp='^[[:digit:]]{8}$'
 [[ $got =~ $exp ]] || err_exit '$((.sh.version)) does not yield YYYYMMDD digits' \
 	"(expected match of ERE $exp, got '$got')"
 
+# ======
+# .sh.stats lists the microseconds spent in each phase of startup
+if	((SHOPT_STATS))
+then	got=$("$SHELL" -c '
+		typeset -i sum=0
+		for p in context names env options locale profile
+		do	((sum += .sh.stats.startup_$p))
+		done
+		print $((.sh.stats.startup_usec > 0 && sum <= .sh.stats.startup_usec && sum + 6 >= .sh.stats.startup_usec))
+	' 2>&1)
+	[[ $got == 1 ]] || err_exit "startup phase times in .sh.stats do not add up (got $(printf %q "$got"))"
+fi
+
 # ======
 exit $((Errors<125?Errors:125))
@@ -0,0 +1,452 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+#include	"dthdr.h"
+
+/*	Hash table with open addressing (linear probing).
+**
+**	Unlike dthash.c, the table itself holds the full hash value of
+**	each object next to its link, so that a search compares objects
+**	only if the hash matches and does not chase one pointer per
+**	collision. The slot number of an object is memoized in its link
+**	(_ppos) so that dtnext() and dtprev() do not need to search for
+**	it; dtprev() and dtlast() walk the table backwards.
+**	Deleted slots are marked and reclaimed when the table is rebuilt;
+**	deleting objects therefore does not move other objects, which
+**	keeps a walk using dtnext() valid while the current object is
+**	deleted, as with the other methods.
+*/
+
+/* these bits should be outside the scope of DT_METHODS */
+#define P_FLATTEN	0200000	/* table was flattened	*/
+
+#define P_DELETED	(&_Dtpdeleted)	/* marker for deleted slot */
+static Dtlink_t		_Dtpdeleted;
+
+#define PISOBJ(l)	((l) && (l) != P_DELETED)
+
+#define P_MINTBL	16	/* minimum table size	*/
+
+/* rebuild when fuller than 3/4, grow to be at most half full */
+#define PFULL(p,n)	(((n) + (p)->ndel) * 4 >= (p)->tblz * 3)
+
+typedef struct _dtpslot_s
+{	uint		hash;	/* hash value of object	*/
+	Dtlink_t*	lnk;	/* object, or NULL or P_DELETED */
+} Dtpslot_t;
+
+typedef struct _dtprobe_s
+{	Dtdata_t	data;
+	int		type;
+	Dtlink_t*	here;	/* fingered object	*/
+	Dtpslot_t*	ptbl;	/* table of slots	*/
+	ssize_t		tblz;	/* size of table	*/
+	ssize_t		ndel;	/* # of deleted slots	*/
+} Dtprobe_t;
+
+/* put link in first free slot for hash value; table must have room */
+static ssize_t pslot(Dtprobe_t* prob, Dtlink_t* l, uint hsh)
+{
+	ssize_t		k, mask = prob->tblz - 1;
+
+	for(k = hsh & mask; PISOBJ(prob->ptbl[k].lnk); k = (k+1) & mask)
+		;
+	if(prob->ptbl[k].lnk == P_DELETED)
+		prob->ndel -= 1;
+	prob->ptbl[k].hash = hsh;
+	prob->ptbl[k].lnk = l;
+	l->_ppos = (uint)k;
+	return k;
+}
+
+/* make/resize table so that it can hold n objects; drops deleted slots */
+static int ptable(Dt_t* dt, ssize_t n)
+{
+	Dtpslot_t	*otbl, *t, *endt;
+	ssize_t		k, otblz;
+	Dtdisc_t	*disc = dt->disc;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	if(!prob->ptbl && disc && disc->eventf) /* let user have input */
+	{	k = 0;
+		if((*disc->eventf)(dt, DT_HASHSIZE, &k, disc) > 0 && k != 0)
+			n = k < 0 ? -k : k;
+	}
+
+	/* table size is a power of 2 and at least twice the # of objects */
+	for(k = P_MINTBL; k < 2*n; )
+		k *= 2;
+
+	if(!(t = (Dtpslot_t*)(*dt->memoryf)(dt, 0, k*sizeof(Dtpslot_t), disc)) )
+	{	DTERROR(dt, "Error in allocating an open addressing hash table");
+		return -1;
+	}
+	memset(t, 0, k*sizeof(Dtpslot_t));
+
+	otbl = prob->ptbl;
+	otblz = prob->tblz;
+	prob->ptbl = t;
+	prob->tblz = k;
+	prob->ndel = 0;
+
+	if(otbl)
+	{	/* move objects into new table */
+		for(endt = (t = otbl) + otblz; t < endt; ++t)
+			if(PISOBJ(t->lnk))
+				pslot(prob, t->lnk, t->hash);
+		(void)(*dt->memoryf)(dt, otbl, 0, disc);
+	}
+
+	return 0;
+}
+
+static void* pclear(Dt_t* dt)
+{
+	Dtpslot_t	*t, *endt;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	prob->here = NULL;
+	prob->data.size = 0;
+	prob->ndel = 0;
+
+	for(endt = (t = prob->ptbl) + prob->tblz; t < endt; ++t)
+	{	if(PISOBJ(t->lnk))
+			_dtfree(dt, t->lnk, DT_DELETE);
+		t->lnk = NULL;
+	}
+
+	return NULL;
+}
+
+/* return first object at or after slot k */
+static void* pfrom(Dt_t* dt, ssize_t k)
+{
+	Dtpslot_t	*t, *endt;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	for(endt = (t = prob->ptbl + k) + (prob->tblz - k); t < endt; ++t)
+	{	if(!PISOBJ(t->lnk))
+			continue;
+		prob->here = t->lnk;
+		return _DTOBJ(dt->disc, t->lnk);
+	}
+
+	return NULL;
+}
+
+/* return last object at or before slot k */
+static void* pupto(Dt_t* dt, ssize_t k)
+{
+	Dtpslot_t	*t;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	for(t = prob->ptbl + k; t >= prob->ptbl; --t)
+	{	if(!PISOBJ(t->lnk))
+			continue;
+		prob->here = t->lnk;
+		return _DTOBJ(dt->disc, t->lnk);
+	}
+
+	return NULL;
+}
+
+#define pfirst(dt)	pfrom((dt), 0)
+#define plast(dt)	pupto((dt), ((Dtprobe_t*)(dt)->data)->tblz - 1)
+#define pnext(dt,l)	pfrom((dt), (ssize_t)(l)->_ppos + 1)
+#define pprev(dt,l)	pupto((dt), (ssize_t)(l)->_ppos - 1)
+#define pstep(dt,l,type)	((type)&DT_PREV ? pprev((dt),(l)) : pnext((dt),(l)))
+
+static void* pflatten(Dt_t* dt, int type)
+{
+	Dtpslot_t	*t, *endt;
+	Dtlink_t	*head, *tail;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	if(type == DT_FLATTEN || type == DT_EXTRACT)
+	{	head = tail = NULL;
+		for(endt = (t = prob->ptbl) + prob->tblz; t < endt; ++t)
+		{	if(PISOBJ(t->lnk))
+			{	if(tail)
+					tail = (tail->_rght = t->lnk);
+				else	head = tail = t->lnk;
+			}
+			if(type == DT_EXTRACT)
+				t->lnk = NULL;
+		}
+		if(tail)
+			tail->_rght = NULL;
+
+		if(type == DT_FLATTEN)
+		{	prob->here = head;
+			prob->type |= P_FLATTEN;
+		}
+		else
+		{	prob->data.size = 0;
+			prob->ndel = 0;
+		}
+
+		return head;
+	}
+	else /* the table is left intact by flattening */
+	{	prob->here = NULL;
+		prob->type &= ~P_FLATTEN;
+		return NULL;
+	}
+}
+
+static void* plist(Dt_t* dt, Dtlink_t* list, int type)
+{
+	void		*obj;
+	Dtlink_t	*l, *next;
+	Dtdisc_t	*disc = dt->disc;
+
+	if(type&DT_FLATTEN)
+		return pflatten(dt, DT_FLATTEN);
+	else if(type&DT_EXTRACT)
+		return pflatten(dt, DT_EXTRACT);
+	else /* if(type&DT_RESTORE) */
+	{	dt->data->size = 0;
+		for(l = list; l; l = next)
+		{	next = l->_rght;
+			obj = _DTOBJ(disc,l);
+			if((*dt->meth->searchf)(dt, l, DT_RELINK) == obj)
+				dt->data->size += 1;
+		}
+		return list;
+	}
+}
+
+static void* pstat(Dt_t* dt, Dtstat_t* st)
+{
+	ssize_t		n, k, mask;
+	Dtpslot_t	*t;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	if(st)
+	{	memset(st, 0, sizeof(Dtstat_t));
+		st->meth  = dt->meth->type;
+		st->size  = prob->data.size;
+		st->space = sizeof(Dtprobe_t) + prob->tblz*sizeof(Dtpslot_t) +
+			    (dt->disc->link >= 0 ? 0 : prob->data.size*sizeof(Dthold_t));
+
+		/* level of an object is its distance from its home slot */
+		mask = prob->tblz - 1;
+		for(k = 0; k < prob->tblz; ++k)
+		{	t = prob->ptbl + k;
+			if(!PISOBJ(t->lnk))
+				continue;
+			n = (k - (ssize_t)(t->hash & mask)) & mask;
+			if(n < DT_MAXSIZE)
+			{	st->lsize[n] += 1;
+				st->msize = n+1 > st->msize ? n+1 : st->msize;
+			}
+			st->mlev = n+1 > st->mlev ? n+1 : st->mlev;
+		}
+	}
+
+	return (void*)prob->data.size;
+}
+
+static void* dtprobe(Dt_t* dt, void* obj, int type)
+{
+	Dtlink_t	*lnk, *l;
+	Dtpslot_t	*t;
+	void		*key, *k, *o;
+	uint		hsh;
+	ssize_t		s, mask, ll;
+	Dtdisc_t	*disc = dt->disc;
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	type = DTTYPE(dt,type); /* map type for upward compatibility */
+	if(!(type&DT_OPERATIONS) )
+		return NULL;
+
+	DTSETLOCK(dt);
+
+	if(!prob->ptbl && ptable(dt, 0) < 0 ) /* initialize hash table */
+		DTRETURN(obj, NULL);
+
+	if(prob->type&P_FLATTEN) /* forget flattened list */
+		pflatten(dt, 0);
+
+	if(type&(DT_FIRST|DT_LAST|DT_CLEAR|DT_EXTRACT|DT_RESTORE|DT_FLATTEN|DT_STAT) )
+	{	if(type&DT_FIRST)
+			DTRETURN(obj, pfirst(dt));
+		else if(type&DT_LAST)
+			DTRETURN(obj, plast(dt));
+		else if(type&DT_CLEAR)
+			DTRETURN(obj, pclear(dt));
+		else if(type&DT_STAT)
+			DTRETURN(obj, pstat(dt, (Dtstat_t*)obj));
+		else /*if(type&(DT_EXTRACT|DT_RESTORE|DT_FLATTEN))*/
+			DTRETURN(obj, plist(dt, (Dtlink_t*)obj, type));
+	}
+
+	lnk = prob->here; /* fingered object */
+	prob->here = NULL;
+
+	if(lnk && obj == _DTOBJ(disc,lnk))
+	{	if(type&DT_SEARCH)
+			DTRETURN(obj, obj);
+		else if(type&(DT_NEXT|DT_PREV) )
+			DTRETURN(obj, pstep(dt,lnk,type));
+	}
+
+	if(type&DT_RELINK)
+	{	lnk = (Dtlink_t*)obj;
+		obj = _DTOBJ(disc,lnk);
+		key = _DTKEY(disc,obj);
+	}
+	else
+	{	lnk = NULL;
+		if((type&DT_MATCH) )
+		{	key = obj;
+			obj = NULL;
+		}
+		else	key = _DTKEY(disc,obj);
+	}
+	hsh = _DTHSH(dt,key,disc);
+
+	mask = prob->tblz - 1;
+	ll = -1; /* slot of the matching object, if any */
+	for(s = hsh & mask; (l = (t = prob->ptbl + s)->lnk); s = (s+1) & mask)
+	{	if(l == P_DELETED || t->hash != hsh)
+			continue;
+		o = _DTOBJ(disc,l); k = _DTKEY(disc,o);
+		if(_DTCMP(dt, key, k, disc) != 0 )
+			continue;
+		else if((type&(DT_REMOVE|DT_NEXT|DT_PREV)) && o != obj )
+		{	if(type&(DT_NEXT|DT_PREV) )
+				ll = s;
+			continue;
+		}
+		else
+		{	ll = s;
+			break;
+		}
+	}
+
+	if(ll >= 0) /* found object */
+	{	t = prob->ptbl + ll;
+		l = t->lnk;
+		if(type&(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST) )
+		{	prob->here = l;
+			DTRETURN(obj, _DTOBJ(disc,l));
+		}
+		else if(type & (DT_NEXT|DT_PREV) )
+			DTRETURN(obj, pstep(dt, l, type));
+		else if(type & (DT_DELETE|DT_DETACH|DT_REMOVE) )
+		{	prob->data.size -= 1;
+			if(prob->ptbl[(ll+1) & mask].lnk)
+			{	t->lnk = P_DELETED;
+				prob->ndel += 1;
+			}
+			else	t->lnk = NULL; /* end of a probe sequence */
+			_dtfree(dt, l, type);
+			DTRETURN(obj, _DTOBJ(disc,l));
+		}
+		else if(type & DT_INSTALL )
+		{	if(dt->meth->type&DT_BAG)
+				goto do_insert;
+			else if(!(lnk = _dtmake(dt, obj, type)) )
+				DTRETURN(obj, NULL );
+			else /* replace old object with new one */
+			{	o = _DTOBJ(disc,l);
+				_dtfree(dt, l, DT_DELETE);
+				DTANNOUNCE(dt, o, DT_DELETE);
+				t->lnk = lnk;
+				lnk->_ppos = (uint)ll;
+				prob->here = lnk;
+				DTRETURN(obj, _DTOBJ(disc,lnk));
+			}
+		}
+		else
+		{	/**/DEBUG_ASSERT(type&(DT_INSERT|DT_ATTACH|DT_APPEND|DT_RELINK));
+			if((dt->meth->type&DT_BAG) )
+				goto do_insert;
+			else
+			{	if(type&(DT_INSERT|DT_APPEND|DT_ATTACH) )
+					type |= DT_MATCH; /* for announcement */
+				else if(lnk && (type&DT_RELINK) )
+				{	/* remove a duplicate */
+					o = _DTOBJ(disc, lnk);
+					_dtfree(dt, lnk, DT_DELETE);
+					DTANNOUNCE(dt, o, DT_DELETE);
+				}
+				DTRETURN(obj, _DTOBJ(disc,l));
+			}
+		}
+	}
+	else /* no matching object */
+	{	if(!(type&(DT_INSERT|DT_INSTALL|DT_APPEND|DT_ATTACH|DT_RELINK)) )
+			DTRETURN(obj, NULL);
+
+	do_insert: /* inserting a new object */
+		if(PFULL(prob, prob->data.size + 1) && ptable(dt, prob->data.size + 1) < 0)
+			DTRETURN(obj, NULL);
+
+		if(!lnk) /* inserting a new object */
+		{	if(!(lnk = _dtmake(dt, obj, type)) )
+				DTRETURN(obj, NULL);
+			prob->data.size += 1;
+		}
+
+		pslot(prob, lnk, hsh);
+
+		prob->here = lnk;
+		DTRETURN(obj, _DTOBJ(disc,lnk));
+	}
+
+dt_return:
+	DTANNOUNCE(dt, obj, type);
+	DTCLRLOCK(dt);
+	return obj;
+}
+
+static int probeevent(Dt_t* dt, int event, void* arg)
+{
+	Dtprobe_t	*prob = (Dtprobe_t*)dt->data;
+
+	NOT_USED(arg);
+	if(event == DT_OPEN)
+	{	if(prob)
+			return 0;
+		if(!(prob = (Dtprobe_t*)(*dt->memoryf)(dt, 0, sizeof(Dtprobe_t), dt->disc)) )
+		{	DTERROR(dt, "Error in allocating an open addressing hash table");
+			return -1;
+		}
+		memset(prob, 0, sizeof(Dtprobe_t));
+		dt->data = (Dtdata_t*)prob;
+		return 1;
+	}
+	else if(event == DT_CLOSE)
+	{	if(!prob)
+			return 0;
+		if(prob->data.size > 0 )
+			(void)pclear(dt);
+		if(prob->ptbl)
+			(void)(*dt->memoryf)(dt, prob->ptbl, 0, dt->disc);
+		(void)(*dt->memoryf)(dt, prob, 0, dt->disc);
+		dt->data = NULL;
+		return 0;
+	}
+	else	return 0;
+}
+
+static Dtmethod_t	_Dtpset = { dtprobe, DT_SET, probeevent, "Dtpset" };
+static Dtmethod_t	_Dtpbag = { dtprobe, DT_BAG, probeevent, "Dtpbag" };
+Dtmethod_t		*Dtpset = &_Dtpset;
+Dtmethod_t		*Dtpbag = &_Dtpbag;
+
+#ifdef NoF
+NoF(dtprobe)
+#endif
@@ -2276,6 +2276,29 @@ Lc_category_t		lc_categories[] =
 static Lc_t*		lang;
 static Lc_t*		lc_all;
 
+/*
+ * the order in which LC_ALL and LANG set the categories;
+ * LC_CTYPE goes first so that the locale has been validated
+ * by the time single() considers deferring the others
+ */
+
+static const unsigned char	lc_order[] =
+{
+	AST_LC_ALL,
+	AST_LC_CTYPE,
+	AST_LC_NUMERIC,
+	AST_LC_COLLATE,
+	AST_LC_MESSAGES,
+	AST_LC_MONETARY,
+	AST_LC_TIME,
+	AST_LC_IDENTIFICATION,
+	AST_LC_ADDRESS,
+	AST_LC_NAME,
+	AST_LC_TELEPHONE,
+	AST_LC_MEASUREMENT,
+	AST_LC_PAPER,
+};
+
 typedef struct Unamval_s
 {
 	char*		name;
@@ -2333,17 +2356,87 @@ default_setlocale(int category, const char* locale)
 
 #endif
 
+/*
+ * set the system locale for category to lc
+ * return the system locale name or 0 if the system does not know lc
+ */
+
+static char*
+syslocale(int category, Lc_t* lc)
+{
+	char*		sys;
+	int		i;
+
+	sys = 0;
+	if (lc_categories[category].external == -lc_categories[category].internal)
+	{
+		for (i = 1; i < AST_LC_COUNT; i++)
+			if (locales[i] == lc)
+			{
+				sys = (char*)lc->name;
+				break;
+			}
+	}
+	else if (lc->flags & (LC_debug|LC_local))
+		sys = setlocale(lc_categories[category].external, lcmake(NULL)->name);
+	else if (!(sys = setlocale(lc_categories[category].external, lc->name)) &&
+		 (streq(lc->name, lc->code) || !(sys = setlocale(lc_categories[category].external, lc->code))) &&
+		 !streq(lc->code, lc->language->code))
+			sys = setlocale(lc_categories[category].external, lc->language->code);
+	return sys;
+}
+
+/*
+ * load a category deferred by single()
+ */
+
+void
+lcload(int category)
+{
+	Lc_category_t*	cp = &lc_categories[category];
+
+	if (cp->flags & LC_pending)
+	{
+		cp->flags &= ~LC_pending;
+		if (!syslocale(category, locales[category]) && cp->external != -cp->internal)
+			setlocale(cp->external, lcmake(NULL)->name);
+		if (cp->setf)
+			(*cp->setf)(cp);
+	}
+}
+
+/*
+ * stand-ins for strcoll() and strxfrm() until LC_COLLATE is loaded
+ */
+
+static int
+pending_strcoll(const char* a, const char* b)
+{
+	lcload(AST_LC_COLLATE);
+	return (*ast.collate)(a, b);
+}
+
+static size_t
+pending_strxfrm(char* t, const char* f, size_t n)
+{
+	lcload(AST_LC_COLLATE);
+	return (*ast.mb_xfrm)(t, f, n);
+}
+
 /*
  * set a single AST_LC_* locale category
  * the caller must validate category
  * lc==0 restores the previous state
+ *
+ * when LC_ALL or LANG set a category other than LC_CTYPE or LC_NUMERIC
+ * to the already validated LC_CTYPE locale, the system setlocale() is
+ * deferred until lcload() is called by the first user of the category
  */
 
 static char*
 single(int category, Lc_t* lc, unsigned int flags)
 {
 	const char*	sys;
-	int		i;
 
 #if AHA
 	if ((ast.locale.set & (AST_LC_debug|AST_LC_setlocale)) && !(ast.locale.set & AST_LC_internal))
@@ -2355,7 +2448,9 @@ single(int category, Lc_t* lc, unsigned int flags)
 			lc_categories[category].prev = lc;
 		if ((flags & LC_setenv) && lc_all && locales[category])
 		{
-			if (lc_categories[category].setf)
+			if (lc_categories[category].flags & LC_pending)
+				lcload(category);
+			else if (lc_categories[category].setf)
 				(*lc_categories[category].setf)(&lc_categories[category]);
 			return (char*)locales[category]->name;
 		}
@@ -2363,24 +2458,29 @@ single(int category, Lc_t* lc, unsigned int flags)
 	if (!lc && (!(lc_categories[category].flags & LC_setlocale) || !(lc = lc_categories[category].prev)) && !(lc = lc_all) && !(lc = lc_categories[category].prev) && !(lc = lang))
 		lc = lcmake(NULL);
 	sys = 0;
-	if (locales[category] != lc)
+	if (locales[category] != lc && !flags && category != AST_LC_CTYPE && category != AST_LC_NUMERIC && lc == locales[AST_LC_CTYPE] && !(lc->flags & LC_debug))
 	{
-		if (lc_categories[category].external == -lc_categories[category].internal)
+		locales[category] = lc;
+		lc_categories[category].flags |= LC_pending;
+		if (category == AST_LC_COLLATE)
 		{
-			for (i = 1; i < AST_LC_COUNT; i++)
-				if (locales[i] == lc)
-				{
-					sys = (char*)lc->name;
-					break;
-				}
+			if (lc->flags & LC_default)
+				set_collate(&lc_categories[category]);
+			else
+			{
+				ast.collate = pending_strcoll;
+				ast.mb_xfrm = pending_strxfrm;
+			}
 		}
-		else if (lc->flags & (LC_debug|LC_local))
-			sys = setlocale(lc_categories[category].external, lcmake(NULL)->name);
-		else if (!(sys = setlocale(lc_categories[category].external, lc->name)) &&
-			 (streq(lc->name, lc->code) || !(sys = setlocale(lc_categories[category].external, lc->code))) &&
-			 !streq(lc->code, lc->language->code))
-				sys = setlocale(lc_categories[category].external, lc->language->code);
-		if (sys)
+		if ((lc->flags & LC_default) || category == AST_LC_MESSAGES && lc->name[0] == 'e' && lc->name[1] == 'n' && (lc->name[2] == 0 || lc->name[2] == '_' && lc->name[3] == 'U'))
+			ast.locale.set &= ~(1<<category);
+		else
+			ast.locale.set |= (1<<category);
+	}
+	else if (locales[category] != lc)
+	{
+		lc_categories[category].flags &= ~LC_pending;
+		if (sys = syslocale(category, lc))
 			lc->flags |= LC_checked;
 		else
 		{
@@ -2413,14 +2513,14 @@ single(int category, Lc_t* lc, unsigned int flags)
 		else
 			ast.locale.set |= (1<<category);
 	}
-	else if (lc_categories[category].flags ^ flags)
+	else if ((lc_categories[category].flags & ~LC_pending) ^ flags)
 	{
 		lc_categories[category].flags &= ~(LC_setenv|LC_setlocale);
 		lc_categories[category].flags |= flags;
 	}
 	else
 	{
-		if (lc_categories[category].setf)
+		if (lc_categories[category].setf && !(lc_categories[category].flags & LC_pending))
 			(*lc_categories[category].setf)(&lc_categories[category]);
 		return (char*)lc->name;
 	}
@@ -2697,12 +2797,15 @@ _ast_setlocale(int category, const char* locale)
 				else
 					lc_categories[i].prev = 0;
 			for (i = 1; i < AST_LC_COUNT; i++)
-				if (!single(i, lc_all && !(lc_categories[i].flags & LC_setlocale) ? lc_all : lc_categories[i].prev, 0))
+			{
+				j = lc_order[i];
+				if (!single(j, lc_all && !(lc_categories[j].flags & LC_setlocale) ? lc_all : lc_categories[j].prev, 0))
 				{
 					while (i--)
-						single(i, NULL, 0);
+						single(lc_order[i], NULL, 0);
 					return NULL;
 				}
+			}
 			if (ast.locale.set & AST_LC_debug)
 				for (i = 1; i < AST_LC_COUNT; i++)
 					sfprintf(sfstderr, "locale env  %17s %16s %16s %16s\n", lc_categories[i].name, locales[i]->name, "", lc_categories[i].prev ? lc_categories[i].prev->name : NULL);
@@ -2724,10 +2827,10 @@ _ast_setlocale(int category, const char* locale)
 			lang = p;
 			if (!lc_all)
 				for (i = 1; i < AST_LC_COUNT; i++)
-					if (!single(i, lc_categories[i].prev, 0))
+					if (!single(lc_order[i], lc_categories[lc_order[i]].prev, 0))
 					{
 						while (i--)
-							single(i, NULL, 0);
+							single(lc_order[i], NULL, 0);
 						return NULL;
 					}
 		}
@@ -2746,12 +2849,15 @@ _ast_setlocale(int category, const char* locale)
 	{
 		lc_all = p;
 		for (i = 1; i < AST_LC_COUNT; i++)
-			if (!single(i, lc_all && !(lc_categories[i].flags & LC_setlocale) ? lc_all : lc_categories[i].prev, 0))
+		{
+			j = lc_order[i];
+			if (!single(j, lc_all && !(lc_categories[j].flags & LC_setlocale) ? lc_all : lc_categories[j].prev, 0))
 			{
 				while (i--)
-					single(i, NULL, 0);
+					single(lc_order[i], NULL, 0);
 				return NULL;
 			}
+		}
 	}
 	goto compose;
 }
@@ -233,6 +233,8 @@ extern Dtmethod_t*	Dtlist;
 extern Dtmethod_t*	Dtstack;
 extern Dtmethod_t*	Dtqueue;
 extern Dtmethod_t*	Dtdeque;
+extern Dtmethod_t*	Dtpset;
+extern Dtmethod_t*	Dtpbag;
 
 /* dtplugin() for proprietary and non-standard methods -- requires -ldll */
 
@@ -72,9 +72,18 @@
 static const char lib[] = "libast:fastfind";
 
 #include "findlib.h"
+#include "FEATURE/mmap"
+
+#if _lib_mmap && _sys_mman
+#include <sys/mman.h>
+#else
+#undef	_lib_mmap
+#endif
 
 #define FIND_MATCH	"*/(find|locate)/*"
 
+#define FF_MAPMIN	(64*1024)	/* smaller codes are not mapped	*/
+
 /*
  * this db could be anywhere
  * findcodes[] directories are checked for findnames[i]
@@ -130,6 +139,34 @@ typefix(char* buf, const char* t)
 	return buf;
 }
 
+/*
+ * return a pointer to the first occurrence of the n byte string f
+ * in b..e-1, or 0 if there is none; f is lower case if icase != 0
+ * candidates are found with memchr(), which is usually vectorized
+ */
+
+static char*
+findfixed(const char* b, const char* e, const char* f, size_t n, int icase)
+{
+	int	c = *f;
+	int	u;
+
+	if (e - b < (ssize_t)n)
+		return NULL;
+	e -= n - 1;
+	if (icase && (u = toupper(c)) != c)
+	{
+		for (; b < e; b++)
+			if ((*b == c || *b == u) && !strncasecmp(b + 1, f + 1, n - 1))
+				return (char*)b;
+		return NULL;
+	}
+	for (; b < e && (b = memchr(b, c, e - b)); b++)
+		if (icase ? !strncasecmp(b + 1, f + 1, n - 1) : !memcmp(b + 1, f + 1, n - 1))
+			return (char*)b;
+	return NULL;
+}
+
 /*
  * return a fastfind stream handle for pattern
  */
@@ -144,6 +181,7 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 	int		i;
 	int		j;
 	char*		path;
+	char*		t;
 	int		brace = 0;
 	int		paren = 0;
 	int		k;
@@ -151,6 +189,8 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 	int		fd;
 	int		uid;
 	Type_t*		tp;
+	Sfio_t*		sp;
+	off_t		off;
 	struct stat	st;
 
 
@@ -347,7 +387,7 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 		i = sizeof(Decode_t) + sizeof(Code_t);
 		if (!pattern || !*pattern)
 			pattern = "*";
-		i += (j = 2 * (strlen(pattern) + 1));
+		i += (j = 3 * (strlen(pattern) + 1));
 		if (!(fp = (Find_t*)calloc(1, sizeof(Find_t) + i)))
 			return NULL;
 		fp->id = lib;
@@ -473,6 +513,31 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 				goto invalid;
 		}
 
+#if _lib_mmap
+		/*
+		 * read the codes from a string stream on a mapping of the file
+		 * so that findread() gets each path without copying it into a
+		 * stream buffer first
+		 */
+
+		if (S_ISREG(st.st_mode) && st.st_size > FF_MAPMIN && (size_t)st.st_size == st.st_size && (off = sftell(fp->fp)) >= 0)
+		{
+			fp->decode.mapsize = st.st_size;
+			if ((fp->decode.map = mmap(NULL, fp->decode.mapsize, PROT_READ|PROT_WRITE, MAP_PRIVATE, sffileno(fp->fp), 0)) == (char*)MAP_FAILED)
+				fp->decode.map = 0;
+			else if (!(sp = sfnew(NULL, fp->decode.map + off, fp->decode.mapsize - off, -1, SFIO_STRING|SFIO_READ)))
+			{
+				munmap(fp->decode.map, fp->decode.mapsize);
+				fp->decode.map = 0;
+			}
+			else
+			{
+				sfclose(fp->fp);
+				fp->fp = sp;
+			}
+		}
+#endif
+
 		/*
 		 * set up the physical dir table
 		 */
@@ -564,7 +629,7 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 					break;
 				case '\\':
 					s = p;
-					if (!*p++)
+					if (!(*b++ = *p++))
 						break;
 					continue;
 				case '[':
@@ -622,15 +687,47 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 			}
 			if (*s)
 			{
+				t = s;
 				*b++ = 0;
 				while (i = *s++)
 					*b++ = i;
 				*b-- = 0;
 				fp->decode.end = b;
+				fp->decode.length = s - t - 1;
 				if (fp->decode.ignorecase)
 					for (s = fp->decode.pattern; s <= b; s++)
 						if (isupper(*s))
 							*s = tolower(*s);
+
+				/*
+				 * without groups or alternation the fixed strings
+				 * up to the first bracket expression must also be
+				 * in a matching path, in order; they are checked
+				 * before the full match
+				 */
+
+				if (fp->decode.match && !strpbrk(pattern, "()|&"))
+				{
+					fp->decode.fixed = s = b + 2;
+					for (p = (char*)pattern, k = 0; p < t && *p != '['; p++)
+					{
+						if (*p == '*' || *p == '?')
+						{
+							if (k)
+								*s++ = k = 0;
+							continue;
+						}
+						if (*p == '\\' && ++p >= t)
+							break;
+						*s++ = fp->decode.ignorecase && isupper(*p) ? tolower(*p) : *p;
+						k = 1;
+					}
+					if (k)
+						*s++ = 0;
+					*s = 0;
+					if (!*fp->decode.fixed)
+						fp->decode.fixed = 0;
+				}
 			}
 		}
 	}
@@ -649,6 +746,10 @@ findopen(const char* file, const char* pattern, const char* type, Finddisc_t* di
 		regfree(&fp->decode.re);
 	if (fp->fp)
 		sfclose(fp->fp);
+#if _lib_mmap
+	if (!fp->generate && fp->decode.map)
+		munmap(fp->decode.map, fp->decode.mapsize);
+#endif
 	return NULL;
 }
 
@@ -713,13 +814,9 @@ findread(Find_t* fp)
 			t = sfgetu(fp->fp);
 			n = sfgetl(fp->fp);
 		grab:
-			p = fp->decode.path + (fp->decode.count += n);
-			do
-			{
-				if ((c = sfgetc(fp->fp)) == EOF)
-					return NULL;
-			} while (*p++ = c);
-			p -= 2;
+			if (!(s = sfgetr(fp->fp, 0, 0)) || (fp->decode.count += n) < 0 || fp->decode.count + (m = sfvalue(fp->fp)) > (int)sizeof(fp->decode.path))
+				return NULL;
+			p = (char*)memcpy(fp->decode.path + fp->decode.count, s, m) + m - 2;
 			break;
 		case FF_old:
 			if (c == EOF)
@@ -853,31 +950,32 @@ findread(Find_t* fp)
 		{
 			if (fp->decode.end)
 			{
+				/*
+				 * the pre-match string must end in b..s
+				 */
+
 				if (*(s = p) == '/')
 					s--;
 				if (*fp->decode.pattern == '/' && b > fp->decode.path)
 					b--;
-				for (; s >= b; s--)
-					if (*s == *fp->decode.end || ignorecase && tolower(*s) == *fp->decode.end)
+				n = fp->decode.length;
+				if ((b -= n - 1) < fp->decode.path)
+					b = fp->decode.path;
+				if (findfixed(b, s + 1, fp->decode.end - n + 1, n, ignorecase))
+				{
+					fp->decode.found = 1;
+					for (e = fp->decode.fixed, q = fp->decode.path; e && *e; e += n + 1, q += n)
+						if (!(q = findfixed(q, p + 1, e, n = strlen(e), ignorecase)))
+							goto next;
+					if (!fp->decode.match || strgrpmatch(fp->decode.path, fp->decode.pattern, NULL, 0, STR_MAXIMAL|STR_LEFT|STR_RIGHT|ignorecase))
 					{
-						if (ignorecase)
-							for (e = fp->decode.end - 1, q = s - 1; *e && (*q == *e || tolower(*q) == *e); e--, q--);
-						else
-							for (e = fp->decode.end - 1, q = s - 1; *e && *q == *e; e--, q--);
-						if (!*e)
-						{
-							fp->decode.found = 1;
-							if (!fp->decode.match || strgrpmatch(fp->decode.path, fp->decode.pattern, NULL, 0, STR_MAXIMAL|STR_LEFT|STR_RIGHT|ignorecase))
-							{
-								fp->decode.peek = c;
-								if (*p == '/')
-									*(fp->decode.restore = p) = 0;
-								if (!fp->secure || !access(fp->decode.path, F_OK))
-									return fp->decode.path;
-							}
-							break;
-						}
+						fp->decode.peek = c;
+						if (*p == '/')
+							*(fp->decode.restore = p) = 0;
+						if (!fp->secure || !access(fp->decode.path, F_OK))
+							return fp->decode.path;
 					}
+				}
 			}
 			else if (!fp->decode.match || !(n = regexec(&fp->decode.re, fp->decode.path, 0, NULL, 0)))
 			{
@@ -1259,5 +1357,9 @@ findclose(Find_t* fp)
 	}
 	if (fp->fp)
 		sfclose(fp->fp);
+#if _lib_mmap
+	if (!fp->generate && fp->decode.map)
+		munmap(fp->decode.map, fp->decode.mapsize);
+#endif
 	return n;
 }
@@ -51,11 +51,15 @@
 typedef struct
 {
 	char*		end;
+	char*		fixed;
 	char*		type;
 	char*		restore;
+	char*		map;
+	size_t		mapsize;
 	int		count;
 	int		found;
 	int		ignorecase;
+	int		length;
 	int		match;
 	int		peek;
 	int		swap;
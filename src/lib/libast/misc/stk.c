@@ -80,12 +80,16 @@ struct stk
 
 static size_t		init;		/* 1 when initialized */
 static struct stk	*stkcur;	/* pointer to current stk */
+static size_t		stkbytes;	/* bytes in the frames of all stacks */
+static size_t		stkpeak;	/* highest value of stkbytes */
 static char		*stkgrow(Sfio_t*, size_t);
 
 #define stream2stk(stream)	((stream)==stkstd? stkcur:\
 				 ((struct stk*)(((char*)(stream))+STK_HDRSIZE)))
 #define stk2stream(sp)		((Sfio_t*)(((char*)(sp))-STK_HDRSIZE))
 #define stkleft(stream)		((stream)->_endb-(stream)->_data)
+#define framesize(fp)		((size_t)(((struct frame*)(fp))->end-(char*)(fp)))
+#define stkcount(n)		((stkbytes+=(n))>stkpeak && (stkpeak=stkbytes))
 
 static const char Omsg[] = "out of memory while growing stack\n";
 
@@ -132,6 +136,7 @@ static int stkexcept(Sfio_t *stream, int type, void* val, Sfdisc_t* dp)
 					while(1)
 					{
 						fp = (struct frame*)cp;
+						stkbytes -= framesize(fp);
 						if(fp->prev)
 						{
 							cp = fp->prev;
@@ -214,6 +219,7 @@ Sfio_t *stkopen(int flags)
 	fp->nalias = 0;
 	fp->aliases = 0;
 	fp->end = sp->stkend = cp+bsize;
+	stkcount(framesize(fp));
 	if(!sfnew(stream,cp,bsize,-1,SFIO_STRING|SFIO_WRITE|SFIO_STATIC|SFIO_EOF))
 		return NULL;
 	sfdisc(stream,dp);
@@ -331,6 +337,7 @@ void *stkset(Sfio_t *stream, void *address, size_t offset)
 		{
 			sp->stkbase = fp->prev;
 			sp->stkend = ((struct frame*)(fp->prev))->end;
+			stkbytes -= framesize(fp);
 			free(fp);
 		}
 		else
@@ -497,6 +504,8 @@ static char *stkgrow(Sfio_t *stream, size_t size)
 	fp->prev = sp->stkbase;
 	sp->stkbase = cp;
 	sp->stkend = fp->end = cp+n;
+	stkbytes -= endoff;
+	stkcount(n);
 	cp = (char*)(fp+1);
 	cp = sp->stkbase + roundof((cp-sp->stkbase),STK_ALIGN);
 	if(fp->nalias=nn)
@@ -512,3 +521,14 @@ static char *stkgrow(Sfio_t *stream, size_t size)
 	sfsetbuf(stream,cp,sp->stkend-cp);
 	return (char*)(stream->_next = stream->_data+m);
 }
+
+/*
+ * return the number of bytes held in the frames of all stacks
+ * if <peak> is not NULL, the highest number so far is stored in *peak
+ */
+size_t stkused(size_t *peak)
+{
+	if(peak)
+		*peak = stkpeak;
+	return stkbytes;
+}
@@ -303,6 +303,7 @@ translate(const char* loc, const char* cmd, const char* cat, const char* msg)
 
 	oerrno = errno;
 	r = (char*)msg;
+	LCLOAD(AST_LC_MESSAGES);
 
 	/*
 	 * quick out
@@ -159,6 +159,7 @@ lcinfo(int category)
 {
 	if ((category = lcindex(category, 0)) < 0)
 		return NULL;
+	LCLOAD(category);
 	return LCINFO(category);
 }
 
@@ -303,6 +303,7 @@ main(int argc, char** argv)
 	fprintf(hf, "#define LC_setlocale\t\t0x10000\n");
 	fprintf(hf, "#define LC_setenv\t\t0x20000\n");
 	fprintf(hf, "#define LC_user\t\t\t0x40000\n");
+	fprintf(hf, "#define LC_pending\t\t0x80000\n");
 	fprintf(lf, "/* : : generated by %s : : */\n", command);
 	fprintf(lf, "\n");
 	fprintf(lf, "#include \"lclib.h\"\n");
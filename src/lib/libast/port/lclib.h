@@ -26,6 +26,7 @@
 
 #define locales		_ast_locales
 #define translate	_ast_translate
+#define lcload		_ast_lcload
 
 #define lc_categories	_ast_lc_categories
 #define lc_charsets	_ast_lc_charsets
@@ -53,6 +54,7 @@ typedef struct Lc_numeric_s
 } Lc_numeric_t;
 
 #define LCINFO(c)	(&locales[c]->info[c])
+#define LCLOAD(c)	do { if (lc_categories[c].flags & LC_pending) lcload(c); } while (0)
 
 extern const Lc_charset_t	lc_charsets[];
 extern const Lc_language_t	lc_languages[];
@@ -63,5 +65,6 @@ extern Lc_category_t		lc_categories[];
 extern Lc_t*			locales[];
 
 extern char*			translate(const char*, const char*, const char*, const char*);
+extern void			lcload(int);
 
 #endif
@@ -60,6 +60,7 @@ _ast_strerror(int err)
 
 #if _lib_strerror
 	z = errno;
+	LCLOAD(AST_LC_MESSAGES);
 	msg = strerror(err);
 	errno = z;
 #else
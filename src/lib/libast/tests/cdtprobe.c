@@ -0,0 +1,236 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+/*
+ * regression tests for the open addressing methods Dtpset and Dtpbag
+ * run by 'bin/package test src/lib/libast'; exits with the number of errors
+ */
+
+#include	<ast.h>
+#include	<cdt.h>
+
+typedef struct Obj_s
+{
+	Dtlink_t	link;
+	int		serial;
+	char		key[16];
+} Obj_t;
+
+static int	errors;
+static int	collide;	/* hash every key to the same value */
+
+#define terror(...)	(sfprintf(sfstderr,"cdtprobe: line %d: ",__LINE__), sfprintf(sfstderr,__VA_ARGS__), sfputc(sfstderr,'\n'), errors++)
+
+static unsigned int hash(Dt_t *dt, void *key, Dtdisc_t *disc)
+{
+	NOT_USED(dt);
+	NOT_USED(disc);
+	return collide ? 42 : dtstrhash(0,key,-1);
+}
+
+static Dtdisc_t	disc;
+
+static Obj_t *newobj(int serial, int k)
+{
+	Obj_t	*op = newof(0,Obj_t,1,0);
+	op->serial = serial;
+	sfsprintf(op->key,sizeof(op->key),"key%d",k);
+	return op;
+}
+
+static Obj_t *find(Dt_t *dt, int k)
+{
+	char	key[16];
+	sfsprintf(key,sizeof(key),"key%d",k);
+	return (Obj_t*)dtmatch(dt,key);
+}
+
+static ssize_t space(Dt_t *dt)
+{
+	Dtstat_t	st;
+	(*dt->searchf)(dt,&st,DT_STAT);
+	return st.space;
+}
+
+/*
+ * a walk with dtlast() and dtprev() visits the objects of a walk
+ * with dtfirst() and dtnext() in reverse order
+ */
+static void reverse(Dt_t *dt)
+{
+	Obj_t	**v = newof(0,Obj_t*,dtsize(dt),0);
+	Obj_t	*op;
+	ssize_t	i, n = 0;
+	for(op = dtfirst(dt); op && n < dtsize(dt); op = dtnext(dt,op))
+		v[n++] = op;
+	i = n;
+	for(op = dtlast(dt); op; op = dtprev(dt,op))
+		if(i == 0 || op != v[--i])
+		{
+			terror("backward walk differs from forward walk at object %zd of %zd",n-i,n);
+			break;
+		}
+	if(!op && i != 0)
+		terror("backward walk visited %zd of %zd objects",n-i,n);
+	free(v);
+}
+
+/*
+ * insert, search, delete and reinsert in a set
+ */
+static void set(int n)
+{
+	Dt_t	*dt = dtopen(&disc,Dtpset);
+	Obj_t	*op, *dup;
+	ssize_t	z;
+	int	i, r;
+	for(i = 0; i < n; i++)
+		if(dtinsert(dt,newobj(i,i)) == 0)
+			terror("insert key%d failed",i);
+	if(dtsize(dt) != n)
+		terror("size %zd after %d inserts",dtsize(dt),n);
+	/* a duplicate key returns the object already in the set */
+	dup = newobj(-1,n/2);
+	if((op = dtinsert(dt,dup)) == dup || !op || op->serial != n/2)
+		terror("duplicate key%d was inserted",n/2);
+	free(dup);
+	for(i = 0; i < n; i++)
+		if(!(op = find(dt,i)) || op->serial != i)
+			terror("key%d not found after insert",i);
+	if(find(dt,n))
+		terror("key%d found but never inserted",n);
+	/* deleting every other object leaves deleted slots in the probe sequences */
+	for(i = 0; i < n; i += 2)
+		if(!(op = find(dt,i)) || dtdelete(dt,op) != op)
+			terror("delete key%d failed",i);
+		else
+			free(op);
+	if(dtsize(dt) != n/2)
+		terror("size %zd after deleting half of %d",dtsize(dt),n);
+	for(i = 0; i < n; i++)
+		if((find(dt,i) != 0) != (i%2 != 0))
+			terror("key%d %s after deletes",i,i%2 ? "lost" : "still found");
+	/* deleted slots are reused: alternating deletes and inserts must not grow the table */
+	z = space(dt);
+	for(r = 0; r < 8*n; r++)
+	{
+		i = 2*(r%(n/2));
+		if(dtinsert(dt,newobj(i,i)) == 0)
+			terror("reinsert key%d failed",i);
+		if(!(op = find(dt,i)) || dtdelete(dt,op) != op)
+			terror("delete reinserted key%d failed",i);
+		else
+			free(op);
+	}
+	if(space(dt) != z)
+		terror("table grew from %zd to %zd bytes while its size stayed at %zd",z,space(dt),dtsize(dt));
+	for(i = 1; i < n; i += 2)
+		if(!(op = find(dt,i)) || op->serial != i)
+			terror("key%d lost after reusing deleted slots",i);
+	reverse(dt);
+	/* a walk stays valid while the current object is deleted */
+	for(op = dtfirst(dt), i = 0; op; op = dup, i++)
+	{
+		dup = dtnext(dt,op);
+		dtdelete(dt,op);
+		free(op);
+	}
+	if(i != n/2 || dtsize(dt) != 0 || dtfirst(dt) || dtlast(dt))
+		terror("walk and delete visited %d of %d objects, %zd left",i,n/2,dtsize(dt));
+	/* an emptied table still grows */
+	for(i = 0; i < 4*n; i++)
+		dtinsert(dt,newobj(i,i));
+	if(dtsize(dt) != 4*n || space(dt) <= z)
+		terror("table did not grow: size %zd, %zd bytes",dtsize(dt),space(dt));
+	for(i = 0; i < 4*n; i++)
+		if(!find(dt,i))
+			terror("key%d not found after growing",i);
+	for(op = dtfirst(dt); op; op = dup)
+	{
+		dup = dtnext(dt,op);
+		dtdelete(dt,op);
+		free(op);
+	}
+	dtclose(dt);
+}
+
+/*
+ * duplicates in a bag
+ */
+static void bag(int n)
+{
+	Dt_t	*dt = dtopen(&disc,Dtpbag);
+	Obj_t	*op, *next, *obj;
+	char	key[16];
+	int	i, j, count;
+	for(i = 0; i < n; i++)
+		for(j = 0; j < 3; j++)
+		{
+			obj = newobj(j,i);
+			if(dtinsert(dt,obj) != obj)
+				terror("bag insert of key%d #%d failed",i,j);
+		}
+	if(dtsize(dt) != 3*n)
+		terror("bag size %zd after %d inserts",dtsize(dt),3*n);
+	reverse(dt);
+	/* remove the middle copy of each key; dtremove() removes that very object */
+	for(i = 0; i < n; i++)
+	{
+		sfsprintf(key,sizeof(key),"key%d",i);
+		for(op = dtfirst(dt); op; op = dtnext(dt,op))
+			if(op->serial == 1 && strcmp(op->key,key) == 0)
+				break;
+		if(!op || dtremove(dt,op) != op)
+			terror("bag remove of key%d #1 failed",i);
+		else
+			free(op);
+	}
+	for(i = 0; i < n; i++)
+	{
+		sfsprintf(key,sizeof(key),"key%d",i);
+		if(!dtmatch(dt,key))
+			terror("bag lost key%d",i);
+		count = 0;
+		for(op = dtfirst(dt); op; op = dtnext(dt,op))
+			if(strcmp(op->key,key) == 0)
+			{
+				if(op->serial == 1)
+					terror("bag removed the wrong copy of key%d",i);
+				count++;
+			}
+		if(count != 2)
+			terror("bag has %d copies of key%d, expected 2",count,i);
+	}
+	for(op = dtfirst(dt); op; op = next)
+	{
+		next = dtnext(dt,op);
+		dtremove(dt,op);
+		free(op);
+	}
+	if(dtsize(dt) != 0)
+		terror("bag size %zd after deleting everything",dtsize(dt));
+	dtclose(dt);
+}
+
+int main(void)
+{
+	DTDISC(&disc,DTOFFSET(Obj_t,key),0,DTOFFSET(Obj_t,link),0,0,0,hash,0,0);
+	set(1000);
+	bag(100);
+	/* with every hash equal, all objects share one probe sequence */
+	collide = 1;
+	set(200);
+	bag(20);
+	if(errors)
+		sfprintf(sfstderr,"cdtprobe: %d error%s\n",errors,errors==1 ? "" : "s");
+	return errors;
+}
@@ -0,0 +1,202 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*            Copyright (c) 2026 Contributors to ksh 93u+m              *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 2.0                  *
+*                                                                      *
+*                A copy of the License is available at                 *
+*      https://www.eclipse.org/org/documents/epl-2.0/EPL-2.0.html      *
+*         (with md5 checksum 84283fa8859daf213bdda5a9f8d1be1d)         *
+*                                                                      *
+***********************************************************************/
+/*
+ * regression tests for the fastfind(3) pre-match filters
+ * every path that findread() returns, and no other, must match the
+ * pattern when it is matched against each path in full
+ * run by 'bin/package test src/lib/libast'; exits with the number of errors
+ */
+
+#include	<ast.h>
+#include	<ctype.h>
+#include	<find.h>
+#include	<regex.h>
+
+static int	errors;
+
+#define terror(...)	(sfprintf(sfstderr,"findprobe: line %d: ",__LINE__), sfprintf(sfstderr,__VA_ARGS__), sfputc(sfstderr,'\n'), errors++)
+
+static const char*	dirs[] = { "usr", "include", "lib", "src", "std", "sys", "Include", "x-y", "stdio" };
+static const char*	files[] = { "stdio.h", "stdlib.h", "string.c", "STDIO.H", "std.c", "io.h", "main.c", "include", "a*b" };
+
+static const char*	patterns[] =
+{
+	"*",
+	"stdio",
+	"std",
+	"include",
+	"*/include/*std*.h",
+	"*/include/*",
+	"*std*io*",
+	"*/std/*.c",
+	"*lib*/*.h",
+	"*s[tu]d*.h",
+	"*/x-y/*",
+	"*a\\*b",
+	"*.[ch]",
+	"*/(std|sys)/*",
+	"*io.h",
+	"usr*",
+	"x-y/[0-9]",
+	"*/src/?std.c",
+	"*nosuch*",
+};
+
+static int cmp(const void* a, const void* b)
+{
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+/*
+ * make <n> distinct paths from the names above, sorted as a find would list them
+ */
+static char** paths(int n)
+{
+	char**		v = newof(0, char*, n + 1, 0);
+	Sfio_t*		sp = sfstropen();
+	unsigned long	r = 1;
+	int		i, j, k, d;
+	for (i = k = 0; i < n; i++)
+	{
+		sfputc(sp, '/');
+		d = 1 + (r = r * 1103515245 + 12345) / 65536 % 5;
+		for (j = 0; j < d; j++)
+			sfprintf(sp, "%s/", dirs[(r = r * 1103515245 + 12345) / 65536 % elementsof(dirs)]);
+		sfprintf(sp, "%d%s", i % 7, files[(r = r * 1103515245 + 12345) / 65536 % elementsof(files)]);
+		v[i] = strdup(sfstruse(sp));
+	}
+	sfclose(sp);
+	qsort(v, n, sizeof(char*), cmp);
+	for (i = k = 0; i < n; i++)
+		if (!k || strcmp(v[i], v[k - 1]))
+			v[k++] = v[i];
+		else
+			free(v[i]);
+	v[k] = 0;
+	return v;
+}
+
+/*
+ * the full match of <path> done by findread() without its pre-match:
+ * a pattern without a glob-free tail is matched anywhere in the path,
+ * other patterns are matched against the whole path, and a pattern
+ * without any glob characters is a substring
+ */
+static int match(const char* path, const char* pattern, int icase)
+{
+	regex_t	re;
+	char*	s;
+	char*	t;
+	int	r;
+	if (streq(pattern, "*"))
+		return 1;
+	if (strchr("*?])", pattern[strlen(pattern) - 1]))
+	{
+		if (regcomp(&re, pattern, REG_SHELL|REG_AUGMENTED|(icase ? REG_ICASE : 0)))
+		{
+			terror("%s: invalid pattern", pattern);
+			return 0;
+		}
+		r = !regexec(&re, path, 0, NULL, 0);
+		regfree(&re);
+		return r;
+	}
+	if (!strpbrk(pattern, "*?[]()|&\\"))
+	{
+		if (!icase)
+			return strstr(path, pattern) != 0;
+		for (s = (char*)path; *s; s++)
+		{
+			for (t = (char*)pattern; *t && tolower(s[t - pattern]) == tolower(*t); t++);
+			if (!*t)
+				return 1;
+		}
+		return 0;
+	}
+	return strgrpmatch(path, pattern, NULL, 0, STR_MAXIMAL|STR_LEFT|STR_RIGHT|(icase ? STR_ICASE : 0));
+}
+
+static void check(const char* file, char** list, const char* method, unsigned long flags)
+{
+	Finddisc_t	disc;
+	Find_t*		fp;
+	char*		s;
+	int		i, j, icase, n;
+	memset(&disc, 0, sizeof(disc));
+	disc.version = FIND_VERSION;
+	disc.flags = FIND_GENERATE | flags;
+	if (!(fp = findopen(file, NULL, NULL, &disc)))
+	{
+		terror("%s: cannot generate %s codes", file, method);
+		return;
+	}
+	for (i = 0; list[i]; i++)
+		findwrite(fp, list[i], strlen(list[i]), (flags & FIND_TYPE) ? "text/plain" : NULL);
+	if (findclose(fp))
+	{
+		terror("%s: cannot write %s codes", file, method);
+		return;
+	}
+	for (icase = 0; icase < 2; icase++)
+		for (j = 0; j < elementsof(patterns); j++)
+		{
+			disc.flags = icase ? FIND_ICASE : 0;
+			if (!(fp = findopen(file, patterns[j], NULL, &disc)))
+			{
+				terror("%s codes: cannot open for %s", method, patterns[j]);
+				continue;
+			}
+			n = 0;
+			for (i = 0; list[i]; i++)
+			{
+				if (!match(list[i], patterns[j], icase))
+					continue;
+				if (!(s = findread(fp)))
+				{
+					terror("%s codes, pattern %s%s: %s not found", method, patterns[j], icase ? " ignoring case" : "", list[i]);
+					break;
+				}
+				if (strcmp(s, list[i]))
+				{
+					terror("%s codes, pattern %s%s: found %s instead of %s", method, patterns[j], icase ? " ignoring case" : "", s, list[i]);
+					break;
+				}
+				n++;
+			}
+			if (!list[i] && (s = findread(fp)))
+				terror("%s codes, pattern %s%s: %s found but does not match", method, patterns[j], icase ? " ignoring case" : "", s);
+			if (!n && !streq(patterns[j], "*nosuch*"))
+				terror("%s codes, pattern %s%s: no paths match; the test is ineffective", method, patterns[j], icase ? " ignoring case" : "");
+			findclose(fp);
+		}
+	remove(file);
+}
+
+int main(void)
+{
+	char	file[PATH_MAX];
+	char**	list;
+	int	n;
+	sfsprintf(file, sizeof(file), "%s/findprobe.%d", getenv("TMPDIR") && *getenv("TMPDIR") == '/' ? getenv("TMPDIR") : "/tmp", (int)getpid());
+	/* a small list is read through a buffer, a large one through a mapping */
+	for (n = 200; n <= 20000; n *= 100)
+	{
+		list = paths(n);
+		check(file, list, "dir", 0);
+		check(file, list, "gnu", FIND_GNU);
+		check(file, list, "typ", FIND_TYPE);
+	}
+	if (errors)
+		sfprintf(sfstderr, "findprobe: %d error%s\n", errors, errors == 1 ? "" : "s");
+	return errors;
+}
@@ -72,6 +72,24 @@ Tm_info_t*		_tm_infop_ = &_tm_info_;
 
 static char*		tz_abbr;
 
+static Tm_zone_t	local;
+
+/*
+ * tmlocal() is expensive, so tminit() keeps the local zones it
+ * computed for the last TM_LOCALCACHE times
+ */
+
+#define TM_LOCALCACHE	4
+
+typedef struct Tm_local_s
+{
+	time_t		now;		/* the time the zone is for	*/
+	int		west;		/* tzwest() for now		*/
+	int		isdst;		/* tzwest() DST state for now	*/
+	int		flags;		/* tm_info.flags		*/
+	Tm_zone_t	zone;		/* the local zone		*/
+} Tm_local_t;
+
 #if _tzset_environ
 
 static char	TZ[256];
@@ -206,8 +224,6 @@ tmlocal(time_t now)
 	struct tm*		tp;
 	char			buf[16];
 
-	static Tm_zone_t	local;
-
 	local.standard = 0;
 	local.daylight = 0;
 
@@ -442,9 +458,14 @@ tmlocal(time_t now)
 void
 tminit(Tm_zone_t* zp, time_t now, const char newzone)
 {
+	Tm_local_t*		lp;
+	int			west;
+	int			isdst;
+
 	static uint32_t		serial = ~(uint32_t)0;
+	static Tm_local_t	cache[TM_LOCALCACHE];
+	static int		next;
 
-	tz_abbr = 0;
 	if (serial != ast.env_serial)
 	{
 		serial = ast.env_serial;
@@ -453,9 +474,38 @@ tminit(Tm_zone_t* zp, time_t now, const char newzone)
 			memset(tm_info.local, 0, sizeof(*tm_info.local));
 			tm_info.local = 0;
 		}
+		memset(cache, 0, sizeof(cache));
 	}
 	if (!tm_info.local || newzone)
-		tmlocal(now);
+	{
+		/*
+		 * a cached zone is used if now is within a day of its time
+		 * and has the same GMT offset and DST state
+		 */
+
+		west = tzwest(&now, &isdst);
+		for (lp = cache; lp < &cache[TM_LOCALCACHE]; lp++)
+			if (lp->zone.standard && lp->west == west && lp->isdst == isdst && lp->now - now <= 24 * 60 * 60 && now - lp->now <= 24 * 60 * 60)
+				break;
+		if (lp < &cache[TM_LOCALCACHE])
+		{
+			local = lp->zone;
+			tm_info.flags = lp->flags;
+			tm_info.zone = tm_info.local = &local;
+		}
+		else
+		{
+			free(tz_abbr);
+			tz_abbr = 0;
+			tmlocal(now);
+			lp = &cache[next];
+			next = (next + 1) % TM_LOCALCACHE;
+			lp->now = now;
+			lp->west = tzwest(&now, &lp->isdst);
+			lp->flags = tm_info.flags;
+			lp->zone = local;
+		}
+	}
 	if (!zp || newzone)
 		zp = tm_info.local;
 	tm_info.zone = zp;
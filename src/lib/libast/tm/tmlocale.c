@@ -634,6 +634,7 @@ tmlocale(void)
 	}
 
 	/* load the locale set in LC_TIME */
+	LCLOAD(AST_LC_TIME);
 	li = LCINFO(AST_LC_TIME);
 	if (!li->data || state.locale != li)
 	{
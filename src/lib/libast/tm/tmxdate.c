@@ -138,6 +138,112 @@ powerize(Tm_t* tm, unsigned long p, unsigned long q, unsigned long u)
 	tm->tm_sec += (int)(t / TMX_RESOLUTION);
 }
 
+/*
+ * fast path for the strict ISO 8601 and RFC 3339 date-times written by
+ * most programs and logs, where all of s must match
+ *
+ *	YYYY-MM-DD{T|t| }hh:mm[:ss[.fraction]][Z|z|{+|-}hh[[:]mm]]
+ *
+ * the value is converted by tmxtime() like the general parser does
+ * return 0 if s does not match so that the general parser handles it
+ */
+
+static int
+isodate(const char* s, Time_t now, Time_t* tp)
+{
+	Tm_t		ts;
+	int		zone;
+	int		n;
+	int		m;
+	int		east;
+
+	for (n = 0; n < 16; n++)
+		if (!s[n] || n != 4 && n != 7 && n != 10 && n != 13 && !isdigit(s[n]))
+			return 0;
+	if (s[4] != '-' || s[7] != '-' || s[10] != 'T' && s[10] != 't' && s[10] != ' ' || s[13] != ':')
+		return 0;
+	memset(&ts, 0, sizeof(ts));
+	dig4(s, n);
+	if (n <= 1970)
+		return 0;
+	ts.tm_year = n - 1900;
+	s++;
+	dig2(s, n);
+	if (n < 1 || n > 12)
+		return 0;
+	ts.tm_mon = n - 1;
+	s++;
+	dig2(s, n);
+	if (n < 1 || n > tm_data.days[ts.tm_mon] + (ts.tm_mon == 1 && tmisleapyear(ts.tm_year + 1900)))
+		return 0;
+	ts.tm_mday = n;
+	s++;
+	dig2(s, ts.tm_hour);
+	s++;
+	dig2(s, ts.tm_min);
+	if (ts.tm_hour > 23 || ts.tm_min > 59)
+		return 0;
+	if (*s == ':')
+	{
+		s++;
+		if (!isdigit(s[0]) || !isdigit(s[1]))
+			return 0;
+		dig2(s, ts.tm_sec);
+		if (ts.tm_sec > 59)
+			return 0;
+		if (*s == '.' && isdigit(s[1]))
+		{
+			m = TMX_RESOLUTION;
+			while (isdigit(*++s))
+			{
+				if (!(m /= 10))
+					return 0;
+				ts.tm_nsec += (*s - '0') * m;
+			}
+		}
+	}
+	if (!*s)
+		zone = TM_LOCALZONE;
+	else if ((*s == 'Z' || *s == 'z') && !*(s + 1))
+		zone = 0;
+	else if (((east = *s == '+') || *s == '-') && isdigit(s[1]) && isdigit(s[2]))
+	{
+		s++;
+		dig2(s, n);
+		m = 0;
+		if (*s)
+		{
+			if (*s == ':')
+				s++;
+			if (!isdigit(s[0]) || !isdigit(s[1]) || s[2])
+				return 0;
+			dig2(s, m);
+		}
+		if (n > 23 || m > 59)
+			return 0;
+		zone = n * 60 + m;
+		if (east)
+			zone = -zone;
+	}
+	else
+		return 0;
+
+	/*
+	 * like the general parser, make the local zone current; it needs
+	 * to be checked against now only if the value is in local time
+	 */
+
+	if (zone == TM_LOCALZONE)
+		tmset(tm_info.zone, tmxsec(now), 1);
+	else
+		tmset(NULL, tmxsec(now), 0);
+	tm_info.date = tm_info.zone;
+	ts.tm_zone = tm_info.zone;
+	ts.tm_isdst = zone == TM_LOCALZONE ? -1 : 0;
+	*tp = tmxtime(&ts, zone);
+	return 1;
+}
+
 #define K1(c1)			(c1)
 #define K2(c1,c2)		(((c1)<<8)|(c2))
 #define K3(c1,c2,c3)		(((c1)<<16)|((c2)<<8)|(c3))
@@ -197,6 +303,12 @@ tmxdate(const char* s, char** e, Time_t now)
 			*e = last;
 		return fix;
 	}
+	if (isodate(s, now, &fix))
+	{
+		if (e)
+			*e = (char*)s + strlen(s);
+		return fix;
+	}
 	o = s;
 
  reset:
@@ -31,8 +31,8 @@
 	int		flags; \
 	Dt_t*		dict; \
 	Dtdisc_t	disc; \
-	FTS*		fts; \
-	FTSENT*		ent; \
+	struct Dlldir_s*	dir; \
+	char**		ent; \
 	Sfio_t*		tmp; \
 	char**		sb; \
 	char**		sp; \
@@ -52,10 +52,15 @@
 #define DLL_MATCH_VERSION	0x2000
 
 #include <ast.h>
+#include <ast_dir.h>
 #include <cdt.h>
 #include <ctype.h>
 #include <error.h>
-#include <fts.h>
+#include <ls.h>
+#include <tmx.h>
+
+#define DLL_MAXDIRS	64		/* start over when more are cached */
+#define DLL_RACY	((Time_t)2000000000)	/* reread a plugin directory modified this close to its read */
 
 typedef struct Uniq_s
 {
@@ -63,6 +68,28 @@ typedef struct Uniq_s
 	char		name[1];
 } Uniq_t;
 
+/*
+ * the sorted names in a library directory are cached, keyed by
+ * device and inode and checked against the directory's mtime, so
+ * that loading several plugins does not read the same directories
+ * again for each one
+ */
+
+typedef struct Dllkey_s
+{
+	dev_t		dev;
+	ino_t		ino;
+} Dllkey_t;
+
+typedef struct Dlldir_s
+{
+	Dtlink_t	link;
+	Dllkey_t	key;
+	Time_t		mtime;		/* 0 if the names must be read again */
+	int		refs;		/* the cache and each scan using it */
+	char**		names;		/* sorted by vercmp(), 0 terminated */
+} Dlldir_t;
+
 #include <dlldefs.h>
 
 static char		bin[] = "bin";
@@ -168,15 +195,15 @@ dllinfo(void)
 }
 
 /*
- * fts version sort order
+ * qsort() version sort order
  * higher versions appear first
  */
 
 static int
-vercmp(FTSENT* const* ap, FTSENT* const* bp)
+vercmp(const void* ap, const void* bp)
 {
-	unsigned char*	a = (unsigned char*)(*ap)->fts_name;
-	unsigned char*	b = (unsigned char*)(*bp)->fts_name;
+	unsigned char*	a = *(unsigned char**)ap;
+	unsigned char*	b = *(unsigned char**)bp;
 	int		n;
 	int		m;
 	char*		e;
@@ -202,6 +229,121 @@ vercmp(FTSENT* const* ap, FTSENT* const* bp)
 	UNREACHABLE();
 }
 
+static void
+dirfree(Dlldir_t* dp)
+{
+	/* the names are in the same block */
+	if (--dp->refs <= 0)
+		free(dp);
+}
+
+static void
+dirdrop(Dt_t* dict, void* obj, Dtdisc_t* disc)
+{
+	NOT_USED(dict);
+	NOT_USED(disc);
+	dirfree((Dlldir_t*)obj);
+}
+
+static Dtdisc_t		dirdisc =
+{
+	offsetof(Dlldir_t, key), sizeof(Dllkey_t), offsetof(Dlldir_t, link), 0, dirdrop
+};
+
+/*
+ * return the cached names in directory dir, reading them if needed
+ * the caller must dirfree() the result
+ */
+
+static Dlldir_t*
+dirget(const char* dir)
+{
+	Dlldir_t*	dp;
+	DIR*		dirf;
+	struct dirent*	ep;
+	Sfio_t*		sp;
+	size_t*		offs;
+	char*		base;
+	size_t		n;
+	size_t		max;
+	Dllkey_t	key;
+	struct stat	st;
+	Time_t		now;
+
+	static Dt_t*	dirs;
+
+	if (stat(dir, &st) || !S_ISDIR(st.st_mode))
+		return NULL;
+	if (!dirs && !(dirs = dtopen(&dirdisc, Dtset)))
+		return NULL;
+	memset(&key, 0, sizeof(key));
+	key.dev = st.st_dev;
+	key.ino = st.st_ino;
+	if (dp = (Dlldir_t*)dtmatch(dirs, &key))
+	{
+		if (dp->mtime && dp->mtime == tmxgetmtime(&st))
+		{
+			dp->refs++;
+			return dp;
+		}
+		dtdelete(dirs, dp);
+	}
+	now = tmxgettime();
+	if (!(dirf = opendir(dir)))
+		return NULL;
+	if (!(sp = sfstropen()))
+	{
+		closedir(dirf);
+		return NULL;
+	}
+	offs = 0;
+	n = max = 0;
+	while (ep = readdir(dirf))
+	{
+		if (ep->d_name[0] == '.' && (!ep->d_name[1] || ep->d_name[1] == '.' && !ep->d_name[2]))
+			continue;
+		if (n >= max)
+		{
+			max = max ? 2 * max : 64;
+			if (!(base = realloc(offs, max * sizeof(size_t))))
+				break;
+			offs = (size_t*)base;
+		}
+		offs[n++] = sfstrtell(sp);
+		sfputr(sp, ep->d_name, 0);
+	}
+	closedir(dirf);
+	if (ep || !(dp = calloc(1, sizeof(Dlldir_t) + (n + 1) * sizeof(char*) + sfstrtell(sp))))
+	{
+		free(offs);
+		sfclose(sp);
+		return NULL;
+	}
+	dp->key = key;
+	dp->mtime = tmxgetmtime(&st);
+	/*
+	 * a library installed in a plugin directory right after it was read
+	 * may not change its mtime if the coarse file system clock has not
+	 * ticked yet; such a directory is read again on the next scan
+	 */
+	if (dp->mtime > now - DLL_RACY)
+		dp->mtime = 0;
+	dp->names = (char**)(dp + 1);
+	base = (char*)(dp->names + n + 1);
+	memcpy(base, sfstrbase(sp), sfstrtell(sp));
+	sfclose(sp);
+	for (max = 0; max < n; max++)
+		dp->names[max] = base + offs[max];
+	dp->names[n] = 0;
+	free(offs);
+	qsort(dp->names, n, sizeof(char*), vercmp);
+	dp->refs = 2;
+	if (dtsize(dirs) >= DLL_MAXDIRS)
+		dtclear(dirs);
+	dtinsert(dirs, dp);
+	return dp;
+}
+
 /*
  * open a scan stream
  */
@@ -351,8 +493,8 @@ dllsclose(Dllscan_t* scan)
 {
 	if (!scan)
 		return -1;
-	if (scan->fts)
-		fts_close(scan->fts);
+	if (scan->dir)
+		dirfree(scan->dir);
 	if (scan->dict)
 		dtclose(scan->dict);
 	if (scan->tmp)
@@ -379,12 +521,13 @@ dllsread(Dllscan_t* scan)
  again:
 	do
 	{
-		while (!scan->ent || !(scan->ent = scan->ent->fts_link))
+		while (!scan->ent || !*++scan->ent)
 		{
-			if (scan->fts)
+			scan->ent = 0;
+			if (scan->dir)
 			{
-				fts_close(scan->fts);
-				scan->fts = 0;
+				dirfree(scan->dir);
+				scan->dir = 0;
 			}
 			if (!scan->pb)
 				scan->pb = pathbin();
@@ -422,12 +565,20 @@ dllsread(Dllscan_t* scan)
 				sfstrseek(scan->tmp, scan->off, SEEK_SET);
 				if (!(t = sfstruse(scan->tmp)))
 					return NULL;
-				if ((scan->fts = fts_open((char**)t, FTS_LOGICAL|FTS_NOPOSTORDER|FTS_ONEPATH, vercmp)) && (scan->ent = fts_read(scan->fts)) && (scan->ent = fts_children(scan->fts, FTS_NOSTAT)))
-					break;
+				if (scan->dir = dirget(t))
+				{
+					if (*scan->dir->names)
+					{
+						scan->ent = scan->dir->names;
+						break;
+					}
+					dirfree(scan->dir);
+					scan->dir = 0;
+				}
 			}
 		}
-	} while (!strmatch(scan->ent->fts_name, scan->pat));
-	b = scan->ent->fts_name;
+	} while (!strmatch(*scan->ent, scan->pat));
+	b = *scan->ent;
 	sfstrseek(scan->tmp, scan->off, SEEK_SET);
 	sfprintf(scan->tmp, "/%s", b);
 	if (!(p = sfstruse(scan->tmp)))